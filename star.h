@@ -8,6 +8,9 @@
         Define `STAR_NO_COLOR` to disable ASCII coloring:
         Define `STAR_NON_FATAL` so failed assertions don't abort the test entirely.
         Define `STAR_VEROBSE` or `STAR_VERBOSE_ASSERTS` for per-assert pass output.
+        Define `STAR_NO_STATIC_ASSERTS` to keep asserts on constant expressions at runtime.
+        Define `STAR_PROFILE_ASSERTS` to report the assertion sites that took the most cycles.
+        Define `STAR_MERGE_MAIN` to turn the entrypoint into `star_merge`, which combines `--record` results.
         
         See the README.md for all features.
 
@@ -18,14 +21,53 @@
 #ifndef STAR_TEST_H
 #define STAR_TEST_H
 
+// The POSIX parts (threads, fork, epoll, inotify) need POSIX.1-2008 declarations from the build, a header cannot
+// turn them on reliably. Without them, e.g. under a plain -std=c11, they drop out and tests run in-process.
+#if defined(__APPLE__)
+#define _STAR_POSIX 1
+#elif defined(__unix__) && (defined(_GNU_SOURCE) || defined(_DEFAULT_SOURCE) || defined(_BSD_SOURCE) ||     \
+    (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200809L) || (defined(_XOPEN_SOURCE) && _XOPEN_SOURCE >= 700) || \
+    (!defined(__STRICT_ANSI__) && !defined(_POSIX_C_SOURCE) && !defined(_XOPEN_SOURCE)))
+#define _STAR_POSIX 1
+#else
+#define _STAR_POSIX 0
+#endif
+
+#if _STAR_POSIX && defined(__linux__)
+#define _STAR_LINUX 1
+#else
+#define _STAR_LINUX 0
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
 #include <float.h>
 #include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include <errno.h>
+#if _STAR_POSIX
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#if _STAR_LINUX
+#include <sys/inotify.h>
+#include <sys/epoll.h>
+#include <ucontext.h>
+#endif
+#endif
 
 #ifdef __cplusplus
+#include <type_traits>
+template <typename T> constexpr bool _star_integral(const T &) { return std::is_integral<T>::value; }
 extern "C" {
 #endif
 
@@ -34,6 +76,8 @@ typedef void (*star_test_func)();
 typedef struct {
     const char *name;
     star_test_func func;
+    size_t mem_budget;   /* peak RSS growth allowed in bytes, 0 for none */
+    void (*async)(void); /* body of a TEST_ASYNC, NULL otherwise */
 } _star_test_case;
 
 static int _star_current_failed = 0;
@@ -61,27 +105,63 @@ static const int _star_verbose = 0;
     #define STAR_FMT_TEST_FAIL     "\033[1;31m[TEST FAILED]\033[0m "
     #define STAR_FMT_PASS_PREFIX   "\033[1;32m[PASS]\033[0m "
     #define STAR_FMT_TEST_PASS     "\033[1;32m[TEST PASSED]\033[0m "
+    #define STAR_FMT_TEST_FLAKY    "\033[1;33m[TEST FLAKY]\033[0m "
+    #define STAR_FMT_TEST_QUARANT  "\033[1;33m[TEST QUARANTINED]\033[0m "
+    #define STAR_FMT_RETRY_PREFIX  "\033[1;33m[RETRY]\033[0m "
     #define STAR_FMT_SUMMARY       "\n\033[1mTechnical and Reliable Summary:\033[0m "
+    #define STAR_FMT_PERF_PREFIX   "\033[1;35m[PERF]\033[0m "
     #define STAR_FMT_FILELINE      "\033[2m%s:%d\033[0m: "
+    #define STAR_FMT_PROFILE       "\033[1mHottest assertion sites:\033[0m"
+    #define STAR_FMT_BISECT        "\033[1mBisecting order dependencies over %zu tests...\033[0m"
+    #define STAR_FMT_MERGE_BINARY  "\n\033[1m%s\033[0m "
+    #define STAR_FMT_WATCH_DIFF    "\n\033[1mChanges since last run:\033[0m"
+    #define STAR_FMT_WATCH_RESTART "\n\033[1mBinary changed, restarting...\033[0m"
+    #define STAR_FMT_WATCH_RERUN   "\n\033[1mInputs changed, running affected tests...\033[0m"
+    #define STAR_FMT_WATCH_WAIT    "\n\033[1mWatching %zu paths for changes, Ctrl-C to stop.\033[0m"
+    #define STAR_FMT_WATCH_BUILD   "\n\033[1mSources changed, running '%s'...\033[0m"
     #define _STAR_CUSTOM(msg)      "\033[36m" msg "\033[0m"
 #else
     #define STAR_FMT_FAIL_PREFIX   "[FAIL] "
     #define STAR_FMT_TEST_FAIL     "[TEST FAILED] "
     #define STAR_FMT_PASS_PREFIX   "[PASS] "
     #define STAR_FMT_TEST_PASS     "[TEST PASSED] "
+    #define STAR_FMT_TEST_FLAKY    "[TEST FLAKY] "
+    #define STAR_FMT_TEST_QUARANT  "[TEST QUARANTINED] "
+    #define STAR_FMT_RETRY_PREFIX  "[RETRY] "
     #define STAR_FMT_SUMMARY       "\nTechnical and Reliable Summary: "
+    #define STAR_FMT_PERF_PREFIX   "[PERF] "
     #define STAR_FMT_FILELINE      "%s:%d: "
+    #define STAR_FMT_PROFILE       "Hottest assertion sites:"
+    #define STAR_FMT_BISECT        "Bisecting order dependencies over %zu tests..."
+    #define STAR_FMT_MERGE_BINARY  "\n%s "
+    #define STAR_FMT_WATCH_DIFF    "\nChanges since last run:"
+    #define STAR_FMT_WATCH_RESTART "\nBinary changed, restarting..."
+    #define STAR_FMT_WATCH_RERUN   "\nInputs changed, running affected tests..."
+    #define STAR_FMT_WATCH_WAIT    "\nWatching %zu paths for changes, Ctrl-C to stop."
+    #define STAR_FMT_WATCH_BUILD   "\nSources changed, running '%s'..."
     #define _STAR_CUSTOM(msg)      msg
 #endif /* STAR_NO_COLOR */
 
 
+#if _STAR_POSIX
+    #define _STAR_LOCK(f)   flockfile(f)
+    #define _STAR_UNLOCK(f) funlockfile(f)
+#else
+    #define _STAR_LOCK(f)   ((void)0)
+    #define _STAR_UNLOCK(f) ((void)0)
+#endif
+
 #define _STAR_FAIL(format, ...)                                      \
     do {                                                             \
+        _STAR_LOCK(stderr);                                          \
         fprintf(stderr, STAR_FMT_FAIL_PREFIX STAR_FMT_FILELINE,      \
                 __FILE__, __LINE__);                                 \
         fprintf(stderr, format "\n", ##__VA_ARGS__);                 \
+        _STAR_UNLOCK(stderr);                                        \
     } while (0)
 
+#define _STAR_NOTE_FAIL(format, ...) fprintf(stderr, STAR_FMT_FAIL_PREFIX format "\n", ##__VA_ARGS__)
+
 #define _STAR_TEST_FAIL(format, ...)                                 \
     do {                                                             \
         fprintf(stderr, STAR_FMT_TEST_FAIL);                         \
@@ -90,17 +170,81 @@ static const int _star_verbose = 0;
 
 #define _STAR_PASS(format, ...)      printf(STAR_FMT_PASS_PREFIX format "\n", ##__VA_ARGS__)
 #define _STAR_TEST_PASS(format, ...) printf(STAR_FMT_TEST_PASS format "\n", ##__VA_ARGS__)
+#define _STAR_TEST_FLAKY(format, ...) printf(STAR_FMT_TEST_FLAKY format "\n", ##__VA_ARGS__)
+#define _STAR_TEST_QUARANT(format, ...) printf(STAR_FMT_TEST_QUARANT format "\n", ##__VA_ARGS__)
+#define _STAR_RETRY(format, ...)     printf(STAR_FMT_RETRY_PREFIX format "\n", ##__VA_ARGS__)
 #define _STAR_SUMMARY(format, ...)   printf(STAR_FMT_SUMMARY format "\n", ##__VA_ARGS__)
+#define _STAR_PERF(format, ...)      printf(STAR_FMT_PERF_PREFIX format "\n", ##__VA_ARGS__)
 
 // Test "Constructor"
-#define TEST(name)                                                        \
-    void name();                                                          \
-    __attribute__((constructor))                                          \
-    void register_##name() {                                              \
-        _star_tests[_star_test_count++] = (_star_test_case){#name, name}; \
-    }                                                                     \
+#define TEST(name)                                                                 \
+    void name();                                                                   \
+    __attribute__((constructor))                                                   \
+    void _star_register_##name() {                                                 \
+        _star_tests[_star_test_count++] = (_star_test_case){#name, name, 0, NULL}; \
+    }                                                                              \
+    void name()
+
+// Fails the test if its peak RSS grows by more than `bytes` while it runs.
+#define TEST_MEMBUDGET(name, bytes)                                                              \
+    void name();                                                                                 \
+    __attribute__((constructor))                                                                 \
+    void _star_register_##name() {                                                               \
+        _star_tests[_star_test_count++] = (_star_test_case){#name, name, (size_t)(bytes), NULL}; \
+    }                                                                                            \
     void name()
 
+#if _STAR_LINUX
+// A test that can wait on fds, timers and conditions with star_await_*(). Run serially, all async
+// tests share one epoll loop and interleave while they wait.
+static inline void __star_async_run_single(void (*body)(void));
+#define TEST_ASYNC(name)                                                                         \
+    static void name##_async(void);                                                              \
+    void name() { __star_async_run_single(name##_async); }                                       \
+    __attribute__((constructor))                                                                 \
+    void _star_register_##name() {                                                               \
+        _star_tests[_star_test_count++] = (_star_test_case){#name, name, 0, name##_async};       \
+    }                                                                                            \
+    static void name##_async(void)
+#endif
+
+// Paths `--watch` keeps an eye on. Sources have no test, data inputs belong to the test that declared them.
+typedef struct {
+    const char *path;
+    const char *test;
+} _star_watch_decl;
+
+static _star_watch_decl _star_watches[256];
+static size_t _star_watch_count = 0;
+static bool _star_watch = false;
+static const char *_star_watch_build = NULL;
+static char **_star_argv = NULL;
+
+static inline void __star_watch_declare(const char *path, const char *test) {
+    if (_star_watch_count < sizeof(_star_watches) / sizeof(_star_watches[0])) {
+        _star_watches[_star_watch_count++] = (_star_watch_decl){path, test};
+    }
+}
+
+#define _STAR_CONCAT_(a, b) a##b
+#define _STAR_CONCAT(a, b)  _STAR_CONCAT_(a, b)
+
+// Declares a source file for `--watch`, at file scope: STAR_WATCH("src/queue.c");
+#define STAR_WATCH(path)                                                  \
+    __attribute__((constructor))                                          \
+    static void _STAR_CONCAT(_star_watch_, __COUNTER__)() {               \
+        __star_watch_declare(path, NULL);                                 \
+    }
+
+// Declares the data files a test reads, at file scope: TEST_INPUTS(test_parse, "data/a.json");
+#define TEST_INPUTS(name, ...)                                            \
+    __attribute__((constructor))                                          \
+    static void register_inputs_##name() {                                \
+        static const char *inputs[] = { __VA_ARGS__ };                    \
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)  \
+            __star_watch_declare(inputs[i], #name);                       \
+    }
+
 static inline bool __star_nearly_equal(double a, double b) {
     if (a == b) return true;
     double diff = fabs(a - b);
@@ -110,14 +254,22 @@ static inline bool __star_nearly_equal(double a, double b) {
     return diff < scale;
 }
 
+// Counters are bumped atomically so asserts stay exact when fired from TEST_CONCURRENT threads.
+static __thread size_t _star_thread_failed = 0;
+
+static inline void __star_increment_total() {
+    __atomic_fetch_add(&_star_asserts_total, 1, __ATOMIC_RELAXED);
+}
+
 static inline void __star_increment_failed() {
-    _star_asserts_failed++;
-    _star_current_failed = 1;
+    __atomic_fetch_add(&_star_asserts_failed, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&_star_current_failed, 1, __ATOMIC_RELAXED);
+    _star_thread_failed++;
 }
     
 /* ASSERTS */
 static inline bool __assert_eq(double a, double b, bool negate) {
-    _star_asserts_total++;
+    __star_increment_total();
 
     bool equal = __star_nearly_equal(a, b);
     bool ok = negate ? !equal : equal;
@@ -130,7 +282,7 @@ static inline bool __assert_eq(double a, double b, bool negate) {
 }
 
 static inline bool __assert_streq(char* a, char* b, bool negate) {
-    _star_asserts_total++;
+    __star_increment_total();
 
     bool equal = (strcmp(a, b) == 0);
     bool ok = negate ? !equal : equal;
@@ -175,11 +327,95 @@ static inline int __star_find_linear(
 }
 
 
+/* COMPILE-TIME ASSERTS */
+// Conditions that are integer constant expressions are checked by the compiler and skip the runtime
+// path entirely (no call, no counter). Define STAR_NO_STATIC_ASSERTS to always check at runtime.
+// `gate` keeps operands whose runtime check differs (epsilon compares of floating values) at runtime.
+
+// The condition is expanded more than once here; only the runtime check should warn about it.
+#define _STAR_CONST_WARN_OFF                              \
+    _Pragma("GCC diagnostic push")                        \
+    _Pragma("GCC diagnostic ignored \"-Wtype-limits\"")  \
+    _Pragma("GCC diagnostic ignored \"-Wsign-compare\"")  \
+    _Pragma("GCC diagnostic ignored \"-Wpointer-arith\"")  \
+    _Pragma("GCC diagnostic ignored \"-Wbool-compare\"")
+#define _STAR_CONST_WARN_ON _Pragma("GCC diagnostic pop")
+
+#if defined(STAR_NO_STATIC_ASSERTS)
+    #define _STAR_CONST_ASSERT_IF(gate, cond, msg) ((void)0)
+    #define _STAR_CONST_ASSERT(cond, msg) ((void)0)
+#elif defined(__cplusplus)
+    // `true ? 0 : (x)` has an integral type exactly when `x` does (enums promote) and is never evaluated.
+    // Unlike decltype it is no unevaluated operand, so lambdas stay allowed before C++20.
+    #define _STAR_INTEGRAL(x) _star_integral(true ? 0 : (x))
+    // Folds `cond` without evaluating it, so tautologies on runtime values (unsigned >= 0) stay legal:
+    // `cond || _star_not_constant` is only constant when `cond` is constant and true. `gate` is folded
+    // the same way and has to come out true.
+    static bool _star_not_constant __attribute__((unused)) = false;
+    #define _STAR_CONST_ASSERT_IF(gate, cond, msg)                                 \
+        _STAR_CONST_WARN_OFF                                                       \
+        constexpr bool _star_const = __builtin_constant_p(cond) &&                 \
+            __builtin_constant_p((gate) || _star_not_constant);                    \
+        static_assert(!_star_const ||                                              \
+                      __builtin_constant_p((cond) || _star_not_constant), msg);    \
+        _STAR_CONST_WARN_ON                                                        \
+        if (_star_const) break
+    #define _STAR_CONST_ASSERT(cond, msg) _STAR_CONST_ASSERT_IF(true, cond, msg)
+#else
+    // Floating operands are never integer constant expressions, so C has no type to check.
+    #define _STAR_INTEGRAL(x) 1
+    // Linux's __is_constexpr: only an integer constant expression makes this a null pointer constant.
+    #define _STAR_IS_ICE(x) (sizeof(int) == sizeof(*(1 ? ((void *)((long)(x) * 0l)) : (int *)1)))
+    #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+        #define _STAR_STATIC_CHECK(ok, msg) _Static_assert(ok, msg);
+    #else
+        // Before C11 glibc turns _Static_assert into a declaration, which a struct cannot hold.
+        #define _STAR_STATIC_CHECK(ok, msg) int _star_check : (ok) ? 1 : -1;
+    #endif
+    #define _STAR_CONST_ASSERT_IF(gate, cond, msg)                                 \
+        _STAR_CONST_WARN_OFF                                                       \
+        enum { _star_const = __builtin_choose_expr(_STAR_IS_ICE(cond),             \
+                                                   (gate), 0) };                   \
+        (void)sizeof(struct {                                                      \
+            _STAR_STATIC_CHECK(__builtin_choose_expr(_star_const, (cond), 1), msg) \
+            char _star_c;                                                          \
+        });                                                                        \
+        _STAR_CONST_WARN_ON                                                        \
+        if (_star_const) break
+    #define _STAR_CONST_ASSERT(cond, msg) _STAR_CONST_ASSERT_IF(1, cond, msg)
+#endif
+
+// ASS_EQ/ASS_NEQ compare as doubles with a relative epsilon at runtime. Integers give the same answer
+// when both are within 2^50 of zero and are compared sign first, so -1 and 0xFFFFFFFFu stay apart.
+#define _STAR_SMALL(x) ((x) < 0 ? (x) >= -(1ll << 50) : (x) <= (1ull << 50))
+#define _STAR_EQ_EXACT(a, b) (_STAR_INTEGRAL(a) && _STAR_INTEGRAL(b) && _STAR_SMALL(a) && _STAR_SMALL(b))
+#define _STAR_SAME(a, b) (((a) < 0) == ((b) < 0) && (a) == (b))
+
+/* ASSERTION PROFILER */
+// With STAR_PROFILE_ASSERTS each assertion gets a static record of its hits and cycles, reported
+// after the run. Assertions checked at compile time never reach it. The clock stops once the check
+// has an answer, so the pass/fail output is not counted.
+#ifdef STAR_PROFILE_ASSERTS
+    #define _STAR_PROF(macro)                                                             \
+        static _star_prof_site _star_site = {__FILE__, __LINE__, macro, 0, 0, 0, NULL};   \
+        _star_prof_scope _star_scope = __star_prof_enter(&_star_site)
+    #define _STAR_PROF_CHECK(failed) __star_prof_check(&_star_scope, (failed))
+    #define _STAR_PROF_STOP() __star_prof_stop(&_star_scope)
+#else
+    #define _STAR_PROF(macro) ((void)0)
+    #define _STAR_PROF_CHECK(failed) (failed)
+    #define _STAR_PROF_STOP() ((void)0)
+#endif
+
 /* MACROS */
 // Equality & Inequality
 #define ASS_EQ(a, b)                                                      \
     do {                                                                  \
-        if (!__assert_eq((double)(a), (double)(b), false)) {              \
+        _STAR_CONST_ASSERT_IF(_STAR_EQ_EXACT(a, b),                       \
+            _STAR_SAME(a, b), "ASS_EQ(" #a ", " #b ") failed");           \
+        _STAR_PROF("ASS_EQ");                                             \
+        if (_STAR_PROF_CHECK(                                             \
+                !__assert_eq((double)(a), (double)(b), false))) {         \
             _STAR_FAIL("ASS_EQ(%s, %s) failed: %lf != %lf",               \
                        #a, #b, (double)(a), (double)(b));                 \
             if (_star_fatal) return;                                      \
@@ -191,7 +427,11 @@ static inline int __star_find_linear(
 
 #define ASS_EQM(a, b, m)                                                  \
     do {                                                                  \
-        if (!__assert_eq((double)(a), (double)(b), false)) {              \
+        _STAR_CONST_ASSERT_IF(_STAR_EQ_EXACT(a, b),                       \
+            _STAR_SAME(a, b), "ASS_EQM(" #a ", " #b ") " m);              \
+        _STAR_PROF("ASS_EQM");                                            \
+        if (_STAR_PROF_CHECK(                                             \
+                !__assert_eq((double)(a), (double)(b), false))) {         \
             _STAR_FAIL("ASS_EQM(%s, %s) %s", #a, #b, _STAR_CUSTOM(m));    \
             if (_star_fatal) return;                                      \
         } else if (_star_verbose) {                                       \
@@ -202,7 +442,11 @@ static inline int __star_find_linear(
 
 #define ASS_NEQ(a, b)                                                     \
     do {                                                                  \
-        if (!__assert_eq((double)(a), (double)(b), true)) {               \
+        _STAR_CONST_ASSERT_IF(_STAR_EQ_EXACT(a, b),                       \
+            !_STAR_SAME(a, b), "ASS_NEQ(" #a ", " #b ") failed");         \
+        _STAR_PROF("ASS_NEQ");                                            \
+        if (_STAR_PROF_CHECK(                                             \
+                !__assert_eq((double)(a), (double)(b), true))) {          \
             _STAR_FAIL("ASS_NEQ(%s, %s) failed: %lf == %lf",              \
                        #a, #b, (double)(a), (double)(b));                 \
             if (_star_fatal) return;                                      \
@@ -214,7 +458,11 @@ static inline int __star_find_linear(
 
 #define ASS_NEQM(a, b, m)                                                 \
     do {                                                                  \
-        if (!__assert_eq((double)(a), (double)(b), true)) {               \
+        _STAR_CONST_ASSERT_IF(_STAR_EQ_EXACT(a, b),                       \
+            !_STAR_SAME(a, b), "ASS_NEQM(" #a ", " #b ") " m);            \
+        _STAR_PROF("ASS_NEQM");                                           \
+        if (_STAR_PROF_CHECK(                                             \
+                !__assert_eq((double)(a), (double)(b), true))) {          \
             _STAR_FAIL("ASS_NEQM(%s, %s) %s", #a, #b, _STAR_CUSTOM(m));   \
             if (_star_fatal) return;                                      \
         } else if (_star_verbose) {                                       \
@@ -225,7 +473,8 @@ static inline int __star_find_linear(
 
 #define ASS_STREQ(a, b)                                                   \
     do {                                                                  \
-        if (!__assert_streq(a, b, false)) {                               \
+        _STAR_PROF("ASS_STREQ");                                          \
+        if (_STAR_PROF_CHECK(!__assert_streq(a, b, false))) {             \
             _STAR_FAIL("ASS_STREQ(%s, %s) failed: %s != %s",              \
                        #a, #b, (a), (b));                                 \
             if (_star_fatal) return;                                      \
@@ -237,7 +486,8 @@ static inline int __star_find_linear(
 
 #define ASS_STREQM(a, b, m)                                               \
     do {                                                                  \
-        if (!__assert_streq(a, b, false)) {                               \
+        _STAR_PROF("ASS_STREQM");                                         \
+        if (_STAR_PROF_CHECK(!__assert_streq(a, b, false))) {             \
             _STAR_FAIL("ASS_STREQM(%s, %s) %s",                           \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             if (_star_fatal) return;                                      \
@@ -250,7 +500,8 @@ static inline int __star_find_linear(
 
 #define ASS_STRNEQ(a, b)                                                  \
     do {                                                                  \
-        if (!__assert_streq(a, b, true)) {                                \
+        _STAR_PROF("ASS_STRNEQ");                                         \
+        if (_STAR_PROF_CHECK(!__assert_streq(a, b, true))) {              \
             _STAR_FAIL("ASS_STRNEQ(%s, %s) failed: %s = %s",              \
                        #a, #b, (a), (b));                                 \
             if (_star_fatal) return;                                      \
@@ -262,7 +513,8 @@ static inline int __star_find_linear(
 
 #define ASS_STRNEQM(a, b, m)                                              \
     do {                                                                  \
-        if (!__assert_streq(a, b, true)) {                                \
+        _STAR_PROF("ASS_STRNEQM");                                        \
+        if (_STAR_PROF_CHECK(!__assert_streq(a, b, true))) {              \
             _STAR_FAIL("ASS_STNRNEQM(%s, %s) %s",                         \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             if (_star_fatal) return;                                      \
@@ -274,9 +526,10 @@ static inline int __star_find_linear(
 
 #define ASS_KINDAEQ(a, b, dptr)                                           \
     do {                                                                  \
-        _star_asserts_total++;                                            \
+        _STAR_PROF("ASS_KINDAEQ");                                        \
+        __star_increment_total();                                         \
         double n = __star_kinda_degree(dptr);                             \
-        if (!__assert_kindaeq((a), (b), n, false)) {                      \
+        if (_STAR_PROF_CHECK(!__assert_kindaeq((a), (b), n, false))) {    \
             _STAR_FAIL("ASS_KINDAEQ(%s, %s) failed: %lf !≈ %lf (degree %lf)", \
                        #a, #b, (double)(a), (double)(b), n);              \
             if (_star_fatal) return;                                      \
@@ -288,9 +541,10 @@ static inline int __star_find_linear(
 
 #define ASS_KINDAEQM(a, b, dptr, m)                                       \
     do {                                                                  \
-        _star_asserts_total++;                                            \
+        _STAR_PROF("ASS_KINDAEQM");                                       \
+        __star_increment_total();                                         \
         double n = __star_kinda_degree(dptr);                             \
-        if (!__assert_kindaeq((a), (b), n, false)) {                      \
+        if (_STAR_PROF_CHECK(!__assert_kindaeq((a), (b), n, false))) {    \
             _STAR_FAIL("ASS_KINDAEQM(%s, %s) %s",                         \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             if (_star_fatal) return;                                      \
@@ -303,9 +557,10 @@ static inline int __star_find_linear(
 
 #define ASS_KINDANEQ(a, b, dptr)                                          \
     do {                                                                  \
-        _star_asserts_total++;                                            \
+        _STAR_PROF("ASS_KINDANEQ");                                       \
+        __star_increment_total();                                         \
         double n = __star_kinda_degree(dptr);                             \
-        if (!__assert_kindaeq((a), (b), n, true)) {                       \
+        if (_STAR_PROF_CHECK(!__assert_kindaeq((a), (b), n, true))) {     \
             _STAR_FAIL("ASS_KINDANEQ(%s, %s) failed: %lf ≈ %lf (degree %lf)", \
                        #a, #b, (double)(a), (double)(b), n);              \
             if (_star_fatal) return;                                      \
@@ -318,9 +573,10 @@ static inline int __star_find_linear(
 
 #define ASS_KINDANEQM(a, b, dptr, m)                                      \
     do {                                                                  \
-        _star_asserts_total++;                                            \
+        _STAR_PROF("ASS_KINDANEQM");                                      \
+        __star_increment_total();                                         \
         double n = __star_kinda_degree(dptr);                             \
-        if (!__assert_kindaeq((a), (b), n, true)) {                       \
+        if (_STAR_PROF_CHECK(!__assert_kindaeq((a), (b), n, true))) {     \
         _STAR_FAIL("ASS_KINDANEQM(%s, %s) %s",                            \
                         #a, #b, _STAR_CUSTOM(m));                         \
             if (_star_fatal) return;                                      \
@@ -332,8 +588,10 @@ static inline int __star_find_linear(
 
 #define ASS_TRUE(expr)                                                    \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if (!(expr)) {                                                    \
+        _STAR_CONST_ASSERT(!!(expr), "ASS_TRUE(" #expr ") failed");       \
+        _STAR_PROF("ASS_TRUE");                                           \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK(!(expr))) {                                  \
             _STAR_FAIL("ASS_TRUE(%s) failed", #expr);                     \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -344,8 +602,10 @@ static inline int __star_find_linear(
 
 #define ASS_TRUEM(expr, m)                                                \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if (!(expr)) {                                                    \
+        _STAR_CONST_ASSERT(!!(expr), "ASS_TRUE(" #expr ") " m);           \
+        _STAR_PROF("ASS_TRUEM");                                          \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK(!(expr))) {                                  \
             _STAR_FAIL("ASS_TRUE(%s) %s", #expr, _STAR_CUSTOM(m));        \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -356,8 +616,10 @@ static inline int __star_find_linear(
 
 #define ASS_FALSE(expr)                                                   \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((expr)) {                                                     \
+        _STAR_CONST_ASSERT(!(expr), "ASS_FALSE(" #expr ") failed");       \
+        _STAR_PROF("ASS_FALSE");                                          \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((expr))) {                                   \
             _STAR_FAIL("ASS_FALSE(%s) failed", #expr);                    \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -368,8 +630,10 @@ static inline int __star_find_linear(
 
 #define ASS_FALSEM(expr, m)                                               \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((expr)) {                                                     \
+        _STAR_CONST_ASSERT(!(expr), "ASS_FALSE(" #expr ") " m);           \
+        _STAR_PROF("ASS_FALSEM");                                         \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((expr))) {                                   \
             _STAR_FAIL("ASS_FALSE(%s) %s", #expr, _STAR_CUSTOM(m));       \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -380,8 +644,9 @@ static inline int __star_find_linear(
 
 #define ASS_IS(a, b)                                                      \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if (memcmp(&(a), &(b), sizeof((a)))) {                            \
+        _STAR_PROF("ASS_IS");                                             \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK(memcmp(&(a), &(b), sizeof((a))))) {          \
             _STAR_FAIL("ASS_IS(%s, %s) failed", #a, #b);                  \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -392,8 +657,9 @@ static inline int __star_find_linear(
 
 #define ASS_ISM(a, b, m)                                                  \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if (memcmp(&(a), &(b), sizeof((a)))) {                            \
+        _STAR_PROF("ASS_ISM");                                            \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK(memcmp(&(a), &(b), sizeof((a))))) {          \
             _STAR_FAIL("ASS_IS(%s, %s) %s", #a, #b, _STAR_CUSTOM(m));     \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -404,8 +670,9 @@ static inline int __star_find_linear(
 
 #define ASS_ISNT(a, b)                                                    \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if (!memcmp(&(a), &(b), sizeof((a)))) {                           \
+        _STAR_PROF("ASS_ISNT");                                           \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK(!memcmp(&(a), &(b), sizeof((a))))) {         \
             _STAR_FAIL("ASS_ISNT(%s, %s) failed", #a, #b);                \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -416,8 +683,9 @@ static inline int __star_find_linear(
 
 #define ASS_ISNTM(a, b, m)                                                \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if (!memcmp(&(a), &(b), sizeof((a)))) {                           \
+        _STAR_PROF("ASS_ISNTM");                                          \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK(!memcmp(&(a), &(b), sizeof((a))))) {         \
             _STAR_FAIL("ASS_ISNT(%s, %s) %s", #a, #b, _STAR_CUSTOM(m));   \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -429,8 +697,9 @@ static inline int __star_find_linear(
 // Null / None / Undefined
 #define ASS_ISNULL(expr)                                                  \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((expr) != NULL) {                                             \
+        _STAR_PROF("ASS_ISNULL");                                         \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((expr) != NULL)) {                           \
             _STAR_FAIL("ASS_ISNULL(%s) failed", #expr);                   \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -441,8 +710,9 @@ static inline int __star_find_linear(
 
 #define ASS_ISNULLM(expr, m)                                              \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((expr) != NULL) {                                             \
+        _STAR_PROF("ASS_ISNULLM");                                        \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((expr) != NULL)) {                           \
             _STAR_FAIL("ASS_ISNULL(%s) %s", #expr, _STAR_CUSTOM(m));      \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -453,8 +723,9 @@ static inline int __star_find_linear(
 
 #define ASS_ISNTNULL(expr)                                                \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((expr) == NULL) {                                             \
+        _STAR_PROF("ASS_ISNTNULL");                                       \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((expr) == NULL)) {                           \
             _STAR_FAIL("ASS_ISNTNULL(%s) failed", #expr);                 \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -465,8 +736,9 @@ static inline int __star_find_linear(
 
 #define ASS_ISNTNULLM(expr, m)                                            \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((expr) == NULL) {                                             \
+        _STAR_PROF("ASS_ISNTNULLM");                                      \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((expr) == NULL)) {                           \
             _STAR_FAIL("ASS_ISNTNULL(%s) %s", #expr, _STAR_CUSTOM(m));    \
             __star_increment_failed();                                    \
             if (_star_fatal) return;                                      \
@@ -478,8 +750,11 @@ static inline int __star_find_linear(
 // Comparisons
 #define ASS_GREATER(a, b)                                                 \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) <= (b)) {                                                 \
+        _STAR_CONST_ASSERT((a) > (b),                                     \
+            "ASS_GREATER(" #a ", " #b ") failed");                        \
+        _STAR_PROF("ASS_GREATER");                                        \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) <= (b))) {                               \
             _STAR_FAIL("ASS_GREATER(%s, %s) failed: %lf <= %lf",          \
                 #a, #b, (double)(a), (double)(b));                        \
             __star_increment_failed();                                    \
@@ -492,8 +767,10 @@ static inline int __star_find_linear(
 
 #define ASS_GREATERM(a, b, m)                                             \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) <= (b)) {                                                 \
+        _STAR_CONST_ASSERT((a) > (b), "ASS_GREATERM(" #a ", " #b ") " m); \
+        _STAR_PROF("ASS_GREATERM");                                       \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) <= (b))) {                               \
             _STAR_FAIL("ASS_GREATERM(%s, %s) %s",                         \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             __star_increment_failed();                                    \
@@ -506,8 +783,11 @@ static inline int __star_find_linear(
 
 #define ASS_GREATEREQ(a, b)                                               \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) < (b)) {                                                  \
+        _STAR_CONST_ASSERT((a) >= (b),                                    \
+            "ASS_GREATEREQ(" #a ", " #b ") failed");                      \
+        _STAR_PROF("ASS_GREATEREQ");                                      \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) < (b))) {                                \
             _STAR_FAIL("ASS_GREATEREQ(%s, %s) failed: %lf < %lf",         \
                 #a, #b, (double)(a), (double)(b));                        \
             __star_increment_failed();                                    \
@@ -520,8 +800,11 @@ static inline int __star_find_linear(
 
 #define ASS_GREATERQM(a, b, m)                                            \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) < (b)) {                                                  \
+        _STAR_CONST_ASSERT((a) >= (b),                                    \
+            "ASS_GREATEREQM(" #a ", " #b ") " m);                         \
+        _STAR_PROF("ASS_GREATERQM");                                      \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) < (b))) {                                \
             _STAR_FAIL("ASS_GREATEREQM(%s, %s) %s",                       \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             __star_increment_failed();                                    \
@@ -534,8 +817,11 @@ static inline int __star_find_linear(
 
 #define ASS_LESSER(a, b)                                                  \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) >= (b)) {                                                 \
+        _STAR_CONST_ASSERT((a) < (b),                                     \
+            "ASS_LESSER(" #a ", " #b ") failed");                         \
+        _STAR_PROF("ASS_LESSER");                                         \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) >= (b))) {                               \
             _STAR_FAIL("ASS_LESSER(%s, %s) failed: %lf >= %lf",           \
                 #a, #b, (double)(a), (double)(b));                        \
             __star_increment_failed();                                    \
@@ -548,8 +834,10 @@ static inline int __star_find_linear(
 
 #define ASS_LESSERM(a, b, m)                                              \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) >= (b)) {                                                 \
+        _STAR_CONST_ASSERT((a) < (b), "ASS_LESSERM(" #a ", " #b ") " m);  \
+        _STAR_PROF("ASS_LESSERM");                                        \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) >= (b))) {                               \
             _STAR_FAIL("ASS_LESSERM(%s, %s) %s",                          \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             __star_increment_failed();                                    \
@@ -562,8 +850,11 @@ static inline int __star_find_linear(
 
 #define ASS_LESSEREQ(a, b)                                                \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) > (b)) {                                                  \
+        _STAR_CONST_ASSERT((a) <= (b),                                    \
+            "ASS_LESSEREQ(" #a ", " #b ") failed");                       \
+        _STAR_PROF("ASS_LESSEREQ");                                       \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) > (b))) {                                \
             _STAR_FAIL("ASS_LESSEREQ(%s, %s) failed: %lf > %lf",          \
                 #a, #b, (double)(a), (double)(b));                        \
             __star_increment_failed();                                    \
@@ -576,8 +867,11 @@ static inline int __star_find_linear(
 
 #define ASS_LESSERQM(a, b, m)                                             \
     do {                                                                  \
-        _star_asserts_total++;                                            \
-        if ((a) > (b)) {                                                  \
+        _STAR_CONST_ASSERT((a) <= (b),                                    \
+            "ASS_LESSEREQM(" #a ", " #b ") " m);                          \
+        _STAR_PROF("ASS_LESSERQM");                                       \
+        __star_increment_total();                                         \
+        if (_STAR_PROF_CHECK((a) > (b))) {                                \
             _STAR_FAIL("ASS_LESSEREQM(%s, %s) %s",                        \
                 #a, #b, _STAR_CUSTOM(m));                                 \
             __star_increment_failed();                                    \
@@ -597,19 +891,22 @@ static inline int __star_find_linear(
 
 #define ASS_IN(item, container)                                                  \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_IN");                                                    \
+        __star_increment_total();                                                \
         int _star_found = 0;                                                     \
         for (int i = 0;                                                          \
              i < (int)(sizeof(container) / sizeof((container)[0]));              \
              i++) {                                                              \
             if (__STAR_VALUE_EQUALS((container)[i], (item))) {                   \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 if (_star_verbose)                                               \
                     _STAR_PASS("ASS_IN(%s, %s) passed: %s found at index %d",    \
                               #item, #container, #item, i);                      \
                 break;                                                           \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found) {                                                      \
             _STAR_FAIL("ASS_IN(%s, %s) failed: %s not found",                    \
                       #item, #container, #item);                                 \
@@ -621,19 +918,22 @@ static inline int __star_find_linear(
 
 #define ASS_INM(item, container, m)                                              \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_INM");                                                   \
+        __star_increment_total();                                                \
         int _star_found = 0;                                                     \
         for (int i = 0;                                                          \
              i < (int)(sizeof(container) / sizeof((container)[0]));              \
              i++) {                                                              \
             if (__STAR_VALUE_EQUALS((container)[i], (item))) {                   \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 if (_star_verbose)                                               \
                     _STAR_PASS("ASS_IN(%s, %s) passed: %s found at index %d",    \
                               #item, #container, #item, i);                      \
                 break;                                                           \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found) {                                                      \
             _STAR_FAIL("ASS_IN(%s, %s) %s",                                      \
                       #item, #container, _STAR_CUSTOM(m));                       \
@@ -644,13 +944,15 @@ static inline int __star_find_linear(
 
 #define ASS_NOTIN(item, container)                                               \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_NOTIN");                                                 \
+        __star_increment_total();                                                \
         int _star_found = 0;                                                     \
         for (int i = 0;                                                          \
              i < (int)(sizeof(container) / sizeof((container)[0]));              \
              i++) {                                                              \
             if (__STAR_VALUE_EQUALS((container)[i], (item))) {                   \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 _STAR_FAIL("ASS_NOTIN(%s, %s) failed: %s found at index %d",     \
                           #item, #container, #item, i);                          \
                 __star_increment_failed();                                       \
@@ -658,6 +960,7 @@ static inline int __star_find_linear(
                 break;                                                           \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found && _star_verbose) {                                     \
             _STAR_PASS("ASS_NOTIN(%s, %s) passed: %s not found",                 \
                       #item, #container, #item);                                 \
@@ -666,13 +969,15 @@ static inline int __star_find_linear(
 
 #define ASS_NOTINM(item, container, m)                                           \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_NOTINM");                                                \
+        __star_increment_total();                                                \
         int _star_found = 0;                                                     \
         for (int i = 0;                                                          \
              i < (int)(sizeof(container) / sizeof((container)[0]));              \
              i++) {                                                              \
             if (__STAR_VALUE_EQUALS((container)[i], (item))) {                   \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 _STAR_FAIL("ASS_NOTIN(%s, %s) %s",                               \
                           #item, #container, _STAR_CUSTOM(m));                   \
                 __star_increment_failed();                                       \
@@ -680,6 +985,7 @@ static inline int __star_find_linear(
                 break;                                                           \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found && _star_verbose) {                                     \
             _STAR_PASS("ASS_NOTIN(%s, %s) passed: %s not found",                 \
                       #item, #container, #item);                                 \
@@ -688,7 +994,8 @@ static inline int __star_find_linear(
 
 #define ASS_INBIN(item, container)                                               \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_INBIN");                                                 \
+        __star_increment_total();                                                \
         int n = (int)sizeof(container) / sizeof((container)[0]);                 \
         int low = 0;                                                             \
         int high = n - 1;                                                        \
@@ -697,6 +1004,7 @@ static inline int __star_find_linear(
             int mid = low + (high - low) / 2;                                    \
             if (__STAR_VALUE_EQUALS((container)[mid], (item))) {                 \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 if (_star_verbose)                                               \
                     _STAR_PASS("ASS_INBIN(%s, %s) passed, %s found at index %d", \
                         #item, #container, #item, mid);                          \
@@ -707,6 +1015,7 @@ static inline int __star_find_linear(
                 high = mid - 1;                                                  \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found) {                                                      \
             _STAR_FAIL("ASS_INBIN(%s, %s) failed: %s not found",                 \
                 #item, #container, #item);                                       \
@@ -717,7 +1026,8 @@ static inline int __star_find_linear(
 
 #define ASS_INBINM(item, container, m)                                           \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_INBINM");                                                \
+        __star_increment_total();                                                \
         int n = (int)sizeof(container) / sizeof((container)[0]);                 \
         int low = 0;                                                             \
         int high = n - 1;                                                        \
@@ -726,6 +1036,7 @@ static inline int __star_find_linear(
             int mid = low + (high - low) / 2;                                    \
             if (__STAR_VALUE_EQUALS((container)[mid], (item))) {                 \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 if (_star_verbose)                                               \
                     _STAR_PASS("ASS_INBINM(%s, %s) passed, %s found at index %d", \
                         #item, #container, #item, mid);                          \
@@ -736,6 +1047,7 @@ static inline int __star_find_linear(
                 high = mid - 1;                                                  \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found) {                                                      \
             _STAR_FAIL("ASS_INBINM(%s, %s) %s",                                  \
                 #item, #container, _STAR_CUSTOM(m));                             \
@@ -746,7 +1058,8 @@ static inline int __star_find_linear(
 
 #define ASS_NOTINBIN(item, container)                                            \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_NOTINBIN");                                              \
+        __star_increment_total();                                                \
         int n = (int)sizeof(container) / sizeof((container)[0]);                 \
         int low = 0;                                                             \
         int high = n - 1;                                                        \
@@ -755,6 +1068,7 @@ static inline int __star_find_linear(
             int mid = low + (high - low) / 2;                                    \
             if (__STAR_VALUE_EQUALS((container)[mid], (item))) {                 \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 _STAR_FAIL("ASS_INBIN(%s, %s) passed: %s found",                 \
                     #item, #container, #item);                                   \
                 __star_increment_failed();                                       \
@@ -766,6 +1080,7 @@ static inline int __star_find_linear(
                 high = mid - 1;                                                  \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found && _star_verbose) {                                     \
             _STAR_PASS("ASS_NOTINBINM(%s, %s) passed: %s not found",             \
                       #item, #container, #item);                                 \
@@ -775,7 +1090,8 @@ static inline int __star_find_linear(
 
 #define ASS_NOTINBINM(item, container, m)                                        \
     do {                                                                         \
-        _star_asserts_total++;                                                   \
+        _STAR_PROF("ASS_NOTINBINM");                                             \
+        __star_increment_total();                                                \
         int n = (int)sizeof(container) / sizeof((container)[0])                  \
         int low = 0;                                                             \
         int high = n - 1;                                                        \
@@ -784,6 +1100,7 @@ static inline int __star_find_linear(
             int mid = low + (high - low) / 2;                                    \
             if (__STAR_VALUE_EQUALS((container[mid], (item)))) {                 \
                 _star_found = 1;                                                 \
+                _STAR_PROF_STOP();                                               \
                 _STAR_FAIL("ASS_NOTINBINM(%s, %s) %s",                           \
                           #item, #container, _STAR_CUSTOM(m));                   \
                 __star_increment_failed();                                       \
@@ -795,6 +1112,7 @@ static inline int __star_find_linear(
                 high = mid - 1;                                                  \
             }                                                                    \
         }                                                                        \
+        _STAR_PROF_STOP();                                                       \
         if (!_star_found && _star_verbose) {                                     \
             _STAR_PASS("ASS_NOTINBINM(%s, %s) passed: %s not found",             \
                       #item, #container, #item);                                 \
@@ -808,49 +1126,2362 @@ static inline int __star_find_linear(
     } while (0)
 
 
-static int __star_run_internal(bool verbose_start) {
+/* CONCURRENCY */
+static inline uint64_t __star_now_ns() {
+#if _STAR_POSIX || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L)
+    struct timespec ts;
+#if _STAR_POSIX
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#else
+    // C99 has no wall clock finer than a second, processor time is the closest stand-in.
+    return (uint64_t)((double)clock() * 1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+#if _STAR_POSIX
+
+static inline void __star_cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static inline void __star_pin_thread(size_t index) {
+#if defined(__linux__) && defined(CPU_SET)
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu <= 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(index % (size_t)ncpu), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+// Spin until every participant has arrived, yielding now and then so oversubscribed cores still make progress.
+static inline void __star_spin_barrier(size_t *arrived, size_t count) {
+    __atomic_fetch_add(arrived, 1, __ATOMIC_ACQ_REL);
+    unsigned spins = 0;
+    while (__atomic_load_n(arrived, __ATOMIC_ACQUIRE) < count) {
+        if (++spins % 1024 == 0) sched_yield();
+        else __star_cpu_relax();
+    }
+}
+
+typedef void (*star_concurrent_func)(size_t);
+
+typedef struct {
+    star_concurrent_func func;
+    size_t   thread;
+    size_t   nthreads;
+    size_t   iterations;
+    size_t  *arrived;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    size_t   done;
+    size_t   failed;
+} _star_worker;
+
+static inline void *__star_concurrent_main(void *arg) {
+    _star_worker *w = (_star_worker *)arg;
+    __star_pin_thread(w->thread);
+    _star_thread_failed = 0;
+
+    __star_spin_barrier(w->arrived, w->nthreads);
+
+    w->start_ns = __star_now_ns();
+    for (w->done = 0; w->done < w->iterations; w->done++) {
+        w->func(w->thread);
+        if (_star_fatal && _star_thread_failed) { w->done++; break; }
+    }
+    w->end_ns = __star_now_ns();
+    w->failed = _star_thread_failed;
+    return NULL;
+}
+
+static inline void __star_run_concurrent(const char *name, star_concurrent_func func, size_t nthreads, size_t iterations) {
+    if (nthreads == 0) nthreads = 1;
+
+    _star_worker *workers = (_star_worker *)calloc(nthreads, sizeof(_star_worker));
+    pthread_t    *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+    size_t arrived = 0;
+    size_t started = 0;
+
+    if (!workers || !threads) {
+        _STAR_NOTE_FAIL("%s: could not allocate %zu workers", name, nthreads);
+        __star_increment_failed();
+        free(workers);
+        free(threads);
+        return;
+    }
+
+    for (size_t t = 0; t < nthreads; t++) {
+        workers[t] = (_star_worker){func, t, nthreads, iterations, &arrived, 0, 0, 0, 0};
+    }
+
+    for (started = 0; started < nthreads; started++) {
+        if (pthread_create(&threads[started], NULL, __star_concurrent_main, &workers[started]) != 0) break;
+    }
+
+    if (started < nthreads) {
+        // Let the threads that did start through the barrier, then report the shortfall.
+        __atomic_fetch_add(&arrived, nthreads - started, __ATOMIC_ACQ_REL);
+        _STAR_NOTE_FAIL("%s: only %zu/%zu threads could be started", name, started, nthreads);
+        __star_increment_failed();
+    }
+
+    uint64_t first = UINT64_MAX, last = 0;
+    size_t ops = 0;
+    for (size_t t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+        if (workers[t].start_ns < first) first = workers[t].start_ns;
+        if (workers[t].end_ns > last) last = workers[t].end_ns;
+        ops += workers[t].done;
+        if (workers[t].failed) {
+            _STAR_NOTE_FAIL("%s: thread %zu had %zu failed assertions after %zu iterations",
+                            name, t, workers[t].failed, workers[t].done);
+        }
+    }
+
+    if (started) {
+        double secs = (last > first ? last - first : 1) / 1e9;
+        _STAR_PERF("%s: %zu threads x %zu iterations, %zu ops in %.3f ms (%.0f ops/sec)",
+                   name, started, iterations, ops, secs * 1e3, ops / secs);
+    }
+
+    free(workers);
+    free(threads);
+}
+
+// Runs the body `iterations` times on each of `nthreads` threads, released together; `star_thread` is the index.
+// Threads are pinned on Linux when the build defines _GNU_SOURCE (CPU_SET must be visible before any libc include).
+#define TEST_CONCURRENT(name, nthreads, iterations)                                    \
+    static void name##_body(size_t star_thread __attribute__((unused)));               \
+    TEST(name) {                                                                       \
+        __star_run_concurrent(#name, name##_body, (nthreads), (iterations));           \
+    }                                                                                  \
+    static void name##_body(size_t star_thread __attribute__((unused)))
+#endif /* _STAR_POSIX */
+
+/* BENCHMARKS */
+#ifndef STAR_BENCH_MIN_MS
+#define STAR_BENCH_MIN_MS 20
+#endif
+
+typedef void (*star_bench_func)(void *, size_t, size_t);
+
+static FILE *_star_bench_csv  = NULL;
+static FILE *_star_bench_json = NULL;
+
+static inline void __star_bench_flush() {
+    if (_star_bench_csv)  fflush(_star_bench_csv);
+    if (_star_bench_json) fflush(_star_bench_json);
+}
+
+#if _STAR_POSIX
+// Ops performed by the current body call, defaults to 1 unless the body reports otherwise.
+static __thread size_t _star_bench_call_ops = 1;
+#define STAR_BENCH_OPS(n) (_star_bench_call_ops = (size_t)(n))
+
+typedef struct {
+    star_bench_func func;
+    void    *buf;
+    size_t   size;
+    size_t   thread;
+    size_t   nthreads;
+    size_t  *arrived;
+    uint64_t elapsed_ns;
+    size_t   ops;
+} _star_bench_worker;
+
+static inline void *__star_bench_main(void *arg) {
+    _star_bench_worker *w = (_star_bench_worker *)arg;
+    __star_pin_thread(w->thread);
+
+    __star_spin_barrier(w->arrived, w->nthreads);
+
+    uint64_t start = __star_now_ns();
+    uint64_t now = start;
+    uint64_t deadline = start + (uint64_t)STAR_BENCH_MIN_MS * 1000000ull;
+    while (now < deadline) {
+        _star_bench_call_ops = 1;
+        w->func(w->buf, w->size, w->thread);
+        w->ops += _star_bench_call_ops;
+        now = __star_now_ns();
+    }
+    w->elapsed_ns = now - start;
+    return NULL;
+}
+
+static inline const char *__star_fmt_bytes(size_t bytes, char *out, size_t len) {
+    const char *units = "BKMGT";
+    int u = 0;
+    while (bytes >= 1024 && bytes % 1024 == 0 && units[u + 1]) { bytes /= 1024; u++; }
+    snprintf(out, len, "%zu%c", bytes, units[u]);
+    return out;
+}
+
+static inline void __star_bench_cell(const char *name, star_bench_func func, size_t size, size_t nthreads) {
+    _star_bench_worker *workers = (_star_bench_worker *)calloc(nthreads, sizeof(_star_bench_worker));
+    pthread_t          *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+    size_t arrived = 0;
+    size_t started = 0;
+    char label[32];
+    __star_fmt_bytes(size, label, sizeof(label));
+
+    if (!workers || !threads) {
+        _STAR_NOTE_FAIL("%s[%s x %zu]: could not allocate workers", name, label, nthreads);
+        __star_increment_failed();
+        free(workers);
+        free(threads);
+        return;
+    }
+
+    // Every thread gets its own working set, touched up front so page faults stay out of the timing.
+    for (size_t t = 0; t < nthreads; t++) {
+        void *buf = size ? malloc(size) : NULL;
+        if (size && !buf) {
+            _STAR_NOTE_FAIL("%s[%s x %zu]: could not allocate working set", name, label, nthreads);
+            __star_increment_failed();
+            nthreads = t;
+            break;
+        }
+        if (buf) memset(buf, (int)t + 1, size);
+        workers[t] = (_star_bench_worker){func, buf, size, t, nthreads, &arrived, 0, 0};
+    }
+    for (size_t t = 0; t < nthreads; t++) workers[t].nthreads = nthreads;
+
+    for (started = 0; started < nthreads; started++) {
+        if (pthread_create(&threads[started], NULL, __star_bench_main, &workers[started]) != 0) break;
+    }
+    if (started < nthreads) {
+        __atomic_fetch_add(&arrived, nthreads - started, __ATOMIC_ACQ_REL);
+        _STAR_NOTE_FAIL("%s[%s x %zu]: only %zu threads could be started", name, label, nthreads, started);
+        __star_increment_failed();
+    }
+
+    uint64_t busy = 0, wall = 0;
+    size_t ops = 0;
+    for (size_t t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+        busy += workers[t].elapsed_ns;
+        ops  += workers[t].ops;
+        if (workers[t].elapsed_ns > wall) wall = workers[t].elapsed_ns;
+    }
+    for (size_t t = 0; t < nthreads; t++) free(workers[t].buf);
+    free(workers);
+    free(threads);
+
+    if (!started || !ops) return;
+
+    double ns_per_op   = (double)busy / (double)ops;
+    double ops_per_sec = (double)ops / ((double)wall / 1e9);
+
+    _STAR_PERF("%-24s %10s %8zu %14.2f %16.0f", name, label, started, ns_per_op, ops_per_sec);
+    if (_star_bench_csv) {
+        fprintf(_star_bench_csv, "%s,%zu,%zu,%zu,%" PRIu64 ",%.4f,%.1f\n",
+                name, size, started, ops, wall, ns_per_op, ops_per_sec);
+    }
+    if (_star_bench_json) {
+        fprintf(_star_bench_json, "{\"bench\":\"%s\",\"size\":%zu,\"threads\":%zu,\"ops\":%zu,"
+                "\"wall_ns\":%" PRIu64 ",\"ns_per_op\":%.4f,\"ops_per_sec\":%.1f}\n",
+                name, size, started, ops, wall, ns_per_op, ops_per_sec);
+    }
+    // Forked workers share these files, so every row goes out whole and before the worker exits.
+    __star_bench_flush();
+}
+
+static inline void __star_bench_range(const char *name, star_bench_func func,
+                                      const size_t *sizes, size_t nsizes,
+                                      const size_t *threads, size_t nthreads) {
+    _STAR_PERF("%-24s %10s %8s %14s %16s", "bench", "size", "threads", "ns/op", "ops/sec");
+    for (size_t s = 0; s < nsizes; s++) {
+        for (size_t t = 0; t < nthreads; t++) {
+            __star_bench_cell(name, func, sizes[s], threads[t] ? threads[t] : 1);
+        }
+    }
+}
+
+#define _STAR_UNPACK(...) __VA_ARGS__
+
+// Runs the body over every (size, threads) pair, e.g. BENCH_RANGE(walk, (32 << 10, 8 << 20), (1, 2, 4)).
+// The body gets a per-thread working set `star_buf` of `star_size` bytes and may report its work with STAR_BENCH_OPS(n).
+#define BENCH_RANGE(name, sizes, threads)                                                      \
+    static void name##_body(void *star_buf, size_t star_size, size_t star_thread);             \
+    static const size_t name##_sizes[]   = { _STAR_UNPACK sizes };                             \
+    static const size_t name##_threads[] = { _STAR_UNPACK threads };                           \
+    TEST(name) {                                                                               \
+        __star_bench_range(#name, name##_body,                                                 \
+                           name##_sizes, sizeof(name##_sizes) / sizeof(name##_sizes[0]),       \
+                           name##_threads, sizeof(name##_threads) / sizeof(name##_threads[0]));\
+    }                                                                                          \
+    static void name##_body(void *star_buf __attribute__((unused)),                            \
+                            size_t star_size __attribute__((unused)),                          \
+                            size_t star_thread __attribute__((unused)))
+#endif /* _STAR_POSIX */
+
+/* HISTORY */
+// strdup() is POSIX and not declared in strict C modes.
+static inline char *__star_strdup(const char *s) {
+    size_t len = strlen(s) + 1;
+    char *copy = (char *)malloc(len);
+    if (copy) memcpy(copy, s, len);
+    return copy;
+}
+
+#ifndef STAR_QUARANTINE_MIN_RUNS
+#define STAR_QUARANTINE_MIN_RUNS 10
+#endif
+
+#ifndef STAR_QUARANTINE_RATE
+#define STAR_QUARANTINE_RATE 0.1
+#endif
+
+typedef struct {
+    char    *name;
+    uint64_t duration_ns;
+    size_t   runs;
+    size_t   failures;
+    size_t   flakes;
+} _star_history_entry;
+
+static char *_star_history_path = NULL;
+static _star_history_entry *_star_history = NULL;
+static size_t _star_history_count = 0;
+
+static inline _star_history_entry *__star_history_find(const char *name) {
+    for (size_t i = 0; i < _star_history_count; i++) {
+        if (strcmp(_star_history[i].name, name) == 0) return &_star_history[i];
+    }
+    return NULL;
+}
+
+static inline _star_history_entry *__star_history_add(const char *name) {
+    _star_history_entry *grown = (_star_history_entry *)realloc(_star_history, (_star_history_count + 1) * sizeof(*grown));
+    if (!grown) return NULL;
+    _star_history = grown;
+    _star_history_entry *e = &_star_history[_star_history_count++];
+    memset(e, 0, sizeof(*e));
+    e->name = __star_strdup(name);
+    return e;
+}
+
+// Entries for tests that are not in this binary are kept, so several binaries may share one file.
+static inline void __star_history_load() {
+    if (!_star_history_path) return;
+    FILE *f = fopen(_star_history_path, "r");
+    if (!f) return;
+
+    char line[512], name[256];
+    unsigned long long duration, runs, failures, flakes;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        runs = failures = flakes = 0;
+        if (sscanf(line, "%255s %llu %llu %llu %llu", name, &duration, &runs, &failures, &flakes) < 2) continue;
+        _star_history_entry *e = __star_history_find(name);
+        if (!e) e = __star_history_add(name);
+        if (!e) continue;
+        e->duration_ns = duration;
+        e->runs        = runs;
+        e->failures    = failures;
+        e->flakes      = flakes;
+    }
+    fclose(f);
+}
+
+// Durations are smoothed so a single noisy run does not reshuffle the schedule, 0 leaves them untouched.
+static inline void __star_history_record(const char *name, uint64_t duration_ns, bool failed, bool flaky) {
+    _star_history_entry *e = __star_history_find(name);
+    if (!e) {
+        e = __star_history_add(name);
+        if (!e) return;
+        e->duration_ns = duration_ns;
+    } else if (duration_ns) {
+        e->duration_ns = e->duration_ns ? (e->duration_ns + duration_ns) / 2 : duration_ns;
+    }
+    e->runs++;
+    if (flaky) e->flakes++;
+    else if (failed) e->failures++;
+}
+
+// Chronically flaky tests still run, but their failures no longer fail the suite.
+static inline bool __star_history_quarantined(const char *name) {
+    _star_history_entry *e = __star_history_find(name);
+    if (!e || e->runs < STAR_QUARANTINE_MIN_RUNS) return false;
+    return (double)e->flakes / (double)e->runs >= STAR_QUARANTINE_RATE;
+}
+
+static inline void __star_history_save() {
+    if (!_star_history_path) return;
+
+    size_t len = strlen(_star_history_path) + 5;
+    char *tmp = (char *)malloc(len);
+    if (!tmp) return;
+    snprintf(tmp, len, "%s.tmp", _star_history_path);
+
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        free(tmp);
+        return;
+    }
+    fprintf(f, "# star history v2: <test> <duration_ns> <runs> <failures> <flakes>\n");
+    for (size_t i = 0; i < _star_history_count; i++) {
+        const _star_history_entry *e = &_star_history[i];
+        fprintf(f, "%s %" PRIu64 " %zu %zu %zu\n", e->name, e->duration_ns, e->runs, e->failures, e->flakes);
+    }
+    fclose(f);
+    rename(tmp, _star_history_path);
+    free(tmp);
+}
+
+/* MEMORY */
+typedef struct {
+    uint64_t rss;       /* bytes */
+    uint64_t hwm;       /* bytes */
+    uint64_t minflt;
+    uint64_t majflt;
+} _star_mem_sample;
+
+static inline void __star_mem_sample(_star_mem_sample *m) {
+    memset(m, 0, sizeof(*m));
+#if _STAR_POSIX
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+        m->minflt = (uint64_t)ru.ru_minflt;
+        m->majflt = (uint64_t)ru.ru_majflt;
+#if defined(__APPLE__)
+        m->hwm = (uint64_t)ru.ru_maxrss;
+#else
+        m->hwm = (uint64_t)ru.ru_maxrss * 1024;
+#endif
+    }
+#endif
+#if _STAR_LINUX
+    FILE *f = fopen("/proc/self/status", "r");
+    if (!f) return;
+    char line[256];
+    unsigned long long kb;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "VmRSS: %llu kB", &kb) == 1) m->rss = kb * 1024;
+        else if (sscanf(line, "VmHWM: %llu kB", &kb) == 1) m->hwm = kb * 1024;
+    }
+    fclose(f);
+#endif
+}
+
+// Resets VmHWM to the current RSS so the next sample gives this test's own peak.
+static inline bool __star_mem_reset_peak() {
+#if _STAR_LINUX
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) return false;
+    bool ok = write(fd, "5", 1) == 1;
+    close(fd);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+/* PROFILER */
+#ifdef STAR_PROFILE_ASSERTS
+#ifndef STAR_PROFILE_TOP
+#define STAR_PROFILE_TOP 10
+#endif
+
+typedef struct _star_prof_site {
+    const char *file;
+    int         line;
+    const char *macro;
+    uint64_t    hits;
+    uint64_t    cycles;
+    int         registered;
+    struct _star_prof_site *next;
+} _star_prof_site;
+
+typedef struct {
+    _star_prof_site *site;
+    uint64_t         start;
+} _star_prof_scope;
+
+static _star_prof_site *_star_prof_sites = NULL;
+
+static inline uint64_t __star_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return __star_now_ns();
+#endif
+}
+
+// A site joins the report list the first time it is hit, so sites that never run cost nothing.
+static inline _star_prof_scope __star_prof_enter(_star_prof_site *site) {
+    if (!__atomic_exchange_n(&site->registered, 1, __ATOMIC_RELAXED)) {
+        site->next = __atomic_load_n(&_star_prof_sites, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&_star_prof_sites, &site->next, site, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {}
+    }
+    return (_star_prof_scope){site, __star_cycles()};
+}
+
+// Called before any reporting. Collection asserts stop where the item is found and again after the
+// loop, so only the first call counts.
+static inline void __star_prof_stop(_star_prof_scope *scope) {
+    if (!scope->site) return;
+    uint64_t cycles = __star_cycles() - scope->start;
+    __atomic_fetch_add(&scope->site->hits, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&scope->site->cycles, cycles, __ATOMIC_RELAXED);
+    scope->site = NULL;
+}
+
+static inline bool __star_prof_check(_star_prof_scope *scope, bool failed) {
+    __star_prof_stop(scope);
+    return failed;
+}
+
+static uint64_t _star_prof_start_cycles = 0;
+static uint64_t _star_prof_start_ns = 0;
+
+static inline void __star_prof_begin() {
+    _star_prof_start_ns     = __star_now_ns();
+    _star_prof_start_cycles = __star_cycles();
+}
+
+static inline int __star_prof_compare(const void *a, const void *b) {
+    uint64_t x = (*(_star_prof_site *const *)a)->cycles, y = (*(_star_prof_site *const *)b)->cycles;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+// Hottest assertion sites by total cycles, with their share of the time spent in tests.
+static inline void __star_prof_report(uint64_t test_ns) {
+    _star_prof_site *sites[1024];
+    size_t n = 0;
+    uint64_t total_cycles = 0, total_hits = 0;
+    for (_star_prof_site *s = __atomic_load_n(&_star_prof_sites, __ATOMIC_ACQUIRE); s; s = s->next) {
+        if (n < sizeof(sites) / sizeof(sites[0])) sites[n++] = s;
+        total_cycles += s->cycles;
+        total_hits   += s->hits;
+    }
+    if (!n) return;
+    qsort(sites, n, sizeof(sites[0]), __star_prof_compare);
+
+    // Converts cycles to time with the rate measured over this run.
+    uint64_t elapsed_ns = __star_now_ns() - _star_prof_start_ns;
+    uint64_t elapsed_cycles = __star_cycles() - _star_prof_start_cycles;
+    double ns_per_cycle = elapsed_cycles ? (double)elapsed_ns / elapsed_cycles : 1.0;
+    double total_ms = total_cycles * ns_per_cycle / 1e6;
+
+    printf(STAR_FMT_PROFILE " %" PRIu64 " hits at %zu sites, %.3f ms", total_hits, n, total_ms);
+    if (test_ns) printf(" (%.1f%% of test time)", 100.0 * total_ms * 1e6 / test_ns);
+    printf("\n");
+    for (size_t i = 0; i < n && i < STAR_PROFILE_TOP; i++) {
+        _star_prof_site *s = sites[i];
+        printf("  %5.1f%%  %12" PRIu64 " cycles  %10" PRIu64 " hits  %10.1f cycles/hit  %s at %s:%d\n",
+               total_cycles ? 100.0 * s->cycles / total_cycles : 0.0, s->cycles, s->hits,
+               s->hits ? (double)s->cycles / s->hits : 0.0, s->macro, s->file, s->line);
+    }
+}
+#endif /* STAR_PROFILE_ASSERTS */
+
+/* RUNNER */
+typedef struct {
+    size_t   index;
+    bool     failed;
+    bool     crashed;
+    bool     flaky;
+    bool     quarantined;
+    unsigned retries;
+    size_t   asserts_total;
+    size_t   asserts_failed;
+    uint64_t duration_ns;
+    uint64_t peak_rss;      /* highest RSS seen during the test, bytes */
+    uint64_t rss_growth;    /* peak RSS above the RSS the test started with, bytes */
+    uint64_t minflt;
+    uint64_t majflt;
+} _star_result;
+
+static size_t _star_jobs = 1;
+static unsigned _star_retries = 0;
+static bool _star_quarantine = true;
+static _star_result _star_results[256];
+
+static inline void __star_run_one(size_t index, _star_result *res) {
+    _star_current_failed = 0;
+
+    _star_mem_sample mem_before, mem_after;
+    bool reset = __star_mem_reset_peak();
+    __star_mem_sample(&mem_before);
+
+    size_t before_total  = _star_asserts_total;
+    size_t before_failed = _star_asserts_failed;
+    uint64_t start = __star_now_ns();
+
+    _star_tests[index].func();
+
+    uint64_t end = __star_now_ns();
+    __star_mem_sample(&mem_after);
+
+    memset(res, 0, sizeof(*res));
+    res->index          = index;
+    res->duration_ns    = end - start;
+    res->minflt         = mem_after.minflt - mem_before.minflt;
+    res->majflt         = mem_after.majflt - mem_before.majflt;
+    res->peak_rss       = mem_after.hwm;
+
+    // Without a reset the high-water mark may belong to an earlier test, so only count it if it moved.
+    uint64_t base = mem_before.rss ? mem_before.rss : mem_before.hwm;
+    if ((reset || mem_after.hwm > mem_before.hwm) && mem_after.hwm > base) res->rss_growth = mem_after.hwm - base;
+
+    size_t budget = _star_tests[index].mem_budget;
+    if (budget && res->rss_growth > budget) {
+        _STAR_NOTE_FAIL("%s: peak RSS grew by %" PRIu64 " KiB, over its budget of %zu KiB",
+                        _star_tests[index].name, res->rss_growth / 1024, budget / 1024);
+        __star_increment_total();
+        __star_increment_failed();
+    } else if (budget) {
+        __star_increment_total();
+    }
+
+    res->asserts_total  = _star_asserts_total  - before_total;
+    res->asserts_failed = _star_asserts_failed - before_failed;
+    res->failed         = _star_current_failed != 0;
+}
+
+static inline void __star_report_result(const _star_result *res) {
+    const char *name = _star_tests[res->index].name;
+    size_t passed = res->asserts_total - res->asserts_failed;
+    double ms = res->duration_ns / 1e6;
+
+    if (res->flaky) {
+        _STAR_TEST_FLAKY("%s: failed, then passed on retry %u of %u", name, res->retries, _star_retries);
+    } else if (res->quarantined) {
+        _STAR_TEST_QUARANT("%s: failed, ignored as a known flaky test", name);
+    } else if (res->crashed) {
+        _STAR_TEST_FAIL("%s: worker crashed", name);
+    } else if (res->failed) {
+        _STAR_TEST_FAIL("%s: %zu/%zu assertions passed (%zu failed) in %.3f ms, RSS +%" PRIu64 " KiB, %" PRIu64 "/%" PRIu64 " faults",
+                        name, passed, res->asserts_total, res->asserts_failed, ms,
+                        res->rss_growth / 1024, res->minflt, res->majflt);
+    } else {
+        _STAR_TEST_PASS("%s: %zu/%zu assertions passed in %.3f ms, RSS +%" PRIu64 " KiB, %" PRIu64 "/%" PRIu64 " faults",
+                        name, passed, res->asserts_total, ms, res->rss_growth / 1024, res->minflt, res->majflt);
+    }
+}
+
+/* ASYNC */
+#if _STAR_LINUX
+#ifndef STAR_ASYNC_STACK
+#define STAR_ASYNC_STACK (256 * 1024)
+#endif
+
+enum { STAR_TASK_READY, STAR_TASK_WAIT_FD, STAR_TASK_WAIT_TIMER, STAR_TASK_WAIT_COND, STAR_TASK_DONE };
+
+typedef struct _star_task {
+    ucontext_t ctx;
+    void      *stack;
+    void     (*body)(void);
+    void     (*fn)(void *);
+    void      *arg;
+    int        state;
+    uint64_t   deadline;          /* absolute ns, 0 for none */
+    bool       timed_out;
+    bool       recheck;           /* woken only to look at its condition again */
+    int        fd;
+    uint32_t   events;
+    struct _star_task *owner;     /* top-level task of the test this task belongs to */
+    size_t     live;              /* owner only: unfinished tasks of the test */
+    size_t     asserts_total;     /* owner only */
+    size_t     asserts_failed;    /* owner only */
+    bool       failed;            /* owner only */
+    uint64_t   finished_ns;       /* owner only */
+} _star_task;
+
+typedef struct {
+    uint64_t    deadline;
+    void      (*cb)(void *);
+    void       *arg;
+    _star_task *owner;            /* test whose assertions the callback counts towards */
+} _star_timer;
+
+typedef struct {
+    int          epfd;
+    ucontext_t   main;
+    _star_task  *current;
+    _star_task **tasks;
+    size_t       ntasks;
+    _star_timer *timers;
+    size_t       ntimers;
+} _star_loop;
+
+static _star_loop *_star_loop_active = NULL;
+
+static inline uint64_t __star_deadline(int timeout_ms) {
+    return timeout_ms < 0 ? 0 : __star_now_ns() + (uint64_t)timeout_ms * 1000000ull;
+}
+
+static inline void __star_task_trampoline(void) {
+    _star_task *t = _star_loop_active->current;
+    if (t->body) t->body();
+    else t->fn(t->arg);
+    t->state = STAR_TASK_DONE;
+}
+
+// Kept apart from __star_loop_spawn so getcontext() has no locals to clobber.
+static inline void __star_task_context(_star_loop *loop, _star_task *t) {
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp   = t->stack;
+    t->ctx.uc_stack.ss_size = STAR_ASYNC_STACK;
+    t->ctx.uc_link          = &loop->main;
+    makecontext(&t->ctx, (void (*)(void))__star_task_trampoline, 0);
+}
+
+static inline _star_task *__star_loop_spawn(_star_loop *loop, void (*body)(void), void (*fn)(void *), void *arg, _star_task *owner) {
+    _star_task **grown = (_star_task **)realloc(loop->tasks, (loop->ntasks + 1) * sizeof(*grown));
+    _star_task *t = (_star_task *)calloc(1, sizeof(_star_task));
+    if (grown) loop->tasks = grown;
+    if (!grown || !t || !(t->stack = malloc(STAR_ASYNC_STACK))) {
+        free(t);
+        return NULL;
+    }
+
+    __star_task_context(loop, t);
+    t->body  = body;
+    t->fn    = fn;
+    t->arg   = arg;
+    t->fd    = -1;
+    t->state = STAR_TASK_READY;
+    t->owner = owner ? owner : t;
+    t->owner->live++;
+    loop->tasks[loop->ntasks++] = t;
+    return t;
+}
+
+// Drops what is left of a test whose body returned: its tasks still waiting and its pending timers.
+static inline void __star_loop_abandon(_star_loop *loop, _star_task *owner) {
+    for (size_t i = 0; i < loop->ntasks; i++) {
+        _star_task *t = loop->tasks[i];
+        if (t->owner != owner || t == owner || t->state == STAR_TASK_DONE) continue;
+        if (t->state == STAR_TASK_WAIT_FD && t->fd >= 0) epoll_ctl(loop->epfd, EPOLL_CTL_DEL, t->fd, NULL);
+        t->fd    = -1;
+        t->state = STAR_TASK_DONE;
+        free(t->stack);
+        t->stack = NULL;
+        owner->live--;
+    }
+    for (size_t i = 0; i < loop->ntimers; ) {
+        if (loop->timers[i].owner == owner) loop->timers[i] = loop->timers[--loop->ntimers];
+        else i++;
+    }
+}
+
+// Switches into `t` until it waits or finishes. Assertions made meanwhile are credited to its test.
+static inline void __star_task_resume(_star_loop *loop, _star_task *t) {
+    size_t before_total  = _star_asserts_total;
+    size_t before_failed = _star_asserts_failed;
+    _star_current_failed = 0;
+
+    loop->current = t;
+    swapcontext(&loop->main, &t->ctx);
+    loop->current = NULL;
+
+    _star_task *owner = t->owner;
+    owner->asserts_total  += _star_asserts_total  - before_total;
+    owner->asserts_failed += _star_asserts_failed - before_failed;
+    if (_star_current_failed) owner->failed = true;
+
+    if (t->state == STAR_TASK_DONE) {
+        free(t->stack);
+        t->stack = NULL;
+        // The test is over once its body returns, e.g. through a fatal assert. A helper left waiting
+        // forever would otherwise keep the whole loop alive.
+        if (t == owner) __star_loop_abandon(loop, owner);
+        if (--owner->live == 0) owner->finished_ns = __star_now_ns();
+    }
+}
+
+static inline void __star_timer_fire(const _star_timer *timer) {
+    size_t before_total  = _star_asserts_total;
+    size_t before_failed = _star_asserts_failed;
+    _star_current_failed = 0;
+
+    timer->cb(timer->arg);
+
+    _star_task *owner = timer->owner;
+    if (!owner || owner->live == 0) return;
+    owner->asserts_total  += _star_asserts_total  - before_total;
+    owner->asserts_failed += _star_asserts_failed - before_failed;
+    if (_star_current_failed) owner->failed = true;
+}
+
+static inline void __star_task_suspend(int state, uint64_t deadline) {
+    _star_task *t = _star_loop_active->current;
+    t->state     = state;
+    t->deadline  = deadline;
+    t->timed_out = false;
+    swapcontext(&t->ctx, &_star_loop_active->main);
+}
+
+// Waits until `fd` is ready for `events` (EPOLLIN, EPOLLOUT, ...). Returns the ready events, 0 on
+// timeout, -1 on error. A negative timeout waits forever. Outside TEST_ASYNC this is a plain poll().
+static inline int star_await_fd(int fd, uint32_t events, int timeout_ms) {
+    if (!_star_loop_active || !_star_loop_active->current) {
+        struct pollfd pfd = {fd, (short)events, 0};
+        int n = poll(&pfd, 1, timeout_ms);
+        return n < 0 ? -1 : n == 0 ? 0 : (int)pfd.revents;
+    }
+
+    _star_task *t = _star_loop_active->current;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = events;
+    ev.data.ptr = t;
+    if (epoll_ctl(_star_loop_active->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) return -1;
+
+    t->fd = fd;
+    t->events = 0;
+    __star_task_suspend(STAR_TASK_WAIT_FD, __star_deadline(timeout_ms));
+    return t->timed_out ? 0 : (int)t->events;
+}
+
+static inline void star_sleep_ms(int ms) {
+    if (!_star_loop_active || !_star_loop_active->current) {
+        struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+        nanosleep(&ts, NULL);
+        return;
+    }
+    __star_task_suspend(STAR_TASK_WAIT_TIMER, __star_deadline(ms < 0 ? 0 : ms));
+}
+
+// Runs `cb(arg)` on the loop after `ms` milliseconds, as long as the test that set it is still running.
+// Only valid inside TEST_ASYNC. Assertions in `cb` count towards the test that set the timer.
+static inline bool star_after(int ms, void (*cb)(void *), void *arg) {
+    _star_loop *loop = _star_loop_active;
+    if (!loop) return false;
+    _star_timer *grown = (_star_timer *)realloc(loop->timers, (loop->ntimers + 1) * sizeof(*grown));
+    if (!grown) return false;
+    loop->timers = grown;
+    loop->timers[loop->ntimers++] = (_star_timer){__star_deadline(ms < 0 ? 0 : ms), cb, arg,
+                                                  loop->current ? loop->current->owner : NULL};
+    return true;
+}
+
+// Starts `fn(arg)` as another task of the current test, e.g. the server side of a socketpair.
+static inline bool star_spawn(void (*fn)(void *), void *arg) {
+    _star_loop *loop = _star_loop_active;
+    if (!loop || !loop->current) return false;
+    return __star_loop_spawn(loop, NULL, fn, arg, loop->current->owner) != NULL;
+}
+
+// Gives the other tasks a turn before star_await_cond() looks at its condition again.
+static inline bool __star_await_cond_wait(uint64_t deadline) {
+    if (deadline && __star_now_ns() >= deadline) return false;
+    if (!_star_loop_active || !_star_loop_active->current) {
+        star_sleep_ms(1);
+        return true;
+    }
+    __star_task_suspend(STAR_TASK_WAIT_COND, deadline);
+    return !_star_loop_active->current->timed_out;
+}
+
+// Waits until `pred` (any expression) holds, re-checking it whenever something else happened on the
+// loop. Evaluates to whether it held before `timeout_ms` ran out.
+#define star_await_cond(pred, timeout_ms)                                           \
+    ({                                                                              \
+        uint64_t _star_deadline = __star_deadline(timeout_ms);                      \
+        bool _star_held;                                                            \
+        while (!(_star_held = (pred)) && __star_await_cond_wait(_star_deadline)) {} \
+        _star_held;                                                                 \
+    })
+
+static inline void __star_loop_run(_star_loop *loop) {
+    struct epoll_event evs[64];
+    unsigned idle = 0;
+
+    for (;;) {
+        bool activity = false;
+        for (size_t i = 0; i < loop->ntasks; i++) {
+            _star_task *t = loop->tasks[i];
+            if (t->state != STAR_TASK_READY) continue;
+            // A task that only re-checked its condition did not change anything by itself.
+            bool recheck = t->recheck;
+            t->recheck = false;
+            __star_task_resume(loop, t);
+            if (!recheck) activity = true;
+        }
+
+        uint64_t now = __star_now_ns(), next = UINT64_MAX;
+        bool live = false, conds = false, ready = false;
+        for (size_t i = 0; i < loop->ntasks; i++) {
+            _star_task *t = loop->tasks[i];
+            if (t->state == STAR_TASK_DONE) continue;
+            live = true;
+            if (t->state == STAR_TASK_READY) ready = true;
+            if (t->state == STAR_TASK_WAIT_COND) conds = true;
+            if (t->deadline && t->deadline < next) next = t->deadline;
+        }
+        if (!live) break;
+        for (size_t i = 0; i < loop->ntimers; i++) {
+            if (loop->timers[i].deadline < next) next = loop->timers[i].deadline;
+        }
+
+        int timeout = -1;
+        if (ready || (conds && activity)) timeout = 0;
+        else if (next != UINT64_MAX) timeout = next <= now ? 0 : (int)((next - now + 999999) / 1000000);
+        if (conds && timeout != 0) {
+            int backoff = 1 << (idle < 4 ? idle : 4);
+            if (timeout < 0 || timeout > backoff) timeout = backoff;
+        }
+
+        int n = epoll_wait(loop->epfd, evs, 64, timeout);
+        for (int i = 0; i < n; i++) {
+            _star_task *t = (_star_task *)evs[i].data.ptr;
+            epoll_ctl(loop->epfd, EPOLL_CTL_DEL, t->fd, NULL);
+            t->fd     = -1;
+            t->events = evs[i].events;
+            t->state  = STAR_TASK_READY;
+            activity  = true;
+        }
+
+        now = __star_now_ns();
+        for (size_t i = 0; i < loop->ntasks; i++) {
+            _star_task *t = loop->tasks[i];
+            if (t->state == STAR_TASK_DONE || t->state == STAR_TASK_READY) continue;
+            if (t->deadline && t->deadline <= now) {
+                if (t->state == STAR_TASK_WAIT_FD) {
+                    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, t->fd, NULL);
+                    t->fd = -1;
+                }
+                t->timed_out = t->state != STAR_TASK_WAIT_TIMER;
+                t->state = STAR_TASK_READY;
+                activity = true;
+            } else if (t->state == STAR_TASK_WAIT_COND) {
+                t->state   = STAR_TASK_READY;
+                t->recheck = true;
+            }
+        }
+
+        for (size_t i = 0; i < loop->ntimers; ) {
+            if (loop->timers[i].deadline > now) { i++; continue; }
+            _star_timer timer = loop->timers[i];
+            loop->timers[i] = loop->timers[--loop->ntimers];
+            __star_timer_fire(&timer);
+            activity = true;
+        }
+
+        idle = activity ? 0 : idle + 1;
+    }
+}
+
+// Runs the async test bodies as tasks on one loop, so their waits overlap. Each result gets the
+// assertions of its own test and the time until its body returned.
+static inline void __star_async_run(void (*const *bodies)(void), size_t count, _star_result *results) {
+    _star_loop loop;
+    memset(&loop, 0, sizeof(loop));
+    loop.epfd = epoll_create1(EPOLL_CLOEXEC);
+
+    _star_task **owners = (_star_task **)calloc(count ? count : 1, sizeof(_star_task *));
+    uint64_t start = __star_now_ns();
+    _star_loop *outer = _star_loop_active;
+    _star_loop_active = &loop;
+
+    for (size_t i = 0; owners && loop.epfd >= 0 && i < count; i++) {
+        owners[i] = __star_loop_spawn(&loop, bodies[i], NULL, NULL, NULL);
+    }
+    if (owners && loop.epfd >= 0) __star_loop_run(&loop);
+    _star_loop_active = outer;
+
+    for (size_t i = 0; i < count; i++) {
+        _star_task *t = owners ? owners[i] : NULL;
+        memset(&results[i], 0, sizeof(results[i]));
+        if (!t) {
+            results[i].failed = true;
+            continue;
+        }
+        results[i].asserts_total  = t->asserts_total;
+        results[i].asserts_failed = t->asserts_failed;
+        results[i].failed         = t->failed;
+        results[i].duration_ns    = t->finished_ns > start ? t->finished_ns - start : 0;
+    }
+
+    for (size_t i = 0; i < loop.ntasks; i++) {
+        free(loop.tasks[i]->stack);
+        free(loop.tasks[i]);
+    }
+    free(loop.tasks);
+    free(loop.timers);
+    free(owners);
+    if (loop.epfd >= 0) close(loop.epfd);
+}
+
+// Body of the TEST function of a TEST_ASYNC, used when it runs on its own (workers, retries, reruns).
+static inline void __star_async_run_single(void (*body)(void)) {
+    _star_result res;
+    __star_async_run(&body, 1, &res);
+    if (res.failed && !res.asserts_failed) _STAR_NOTE_FAIL("could not start the async loop");
+    _star_current_failed = res.failed;
+}
+
+// Runs the async tests among order[from..count) together on one loop and reports them.
+// Returns how many there were; the serial runner skips them afterwards.
+static inline size_t __star_async_run_serial(const size_t *order, size_t from, size_t count) {
+    void (*bodies[256])(void);
+    size_t indices[256], n = 0;
+    for (size_t i = from; i < count; i++) {
+        if (!_star_tests[order[i]].async) continue;
+        indices[n]  = order[i];
+        bodies[n++] = _star_tests[order[i]].async;
+    }
+
+    _star_result results[256];
+    __star_async_run(bodies, n, results);
+
+    for (size_t i = 0; i < n; i++) {
+        results[i].index = indices[i];
+        if (results[i].failed && !results[i].asserts_failed) {
+            _STAR_NOTE_FAIL("%s: could not start the async loop", _star_tests[indices[i]].name);
+        }
+        _star_results[indices[i]] = results[i];
+        __star_report_result(&_star_results[indices[i]]);
+    }
+    return n;
+}
+#endif /* _STAR_LINUX */
+
+// Longest-first (LPT) order from recorded durations. Unknown tests are assumed to take the average.
+// Returns the lower bound on the makespan, tests estimated at or above it are flagged as slow.
+static inline uint64_t __star_schedule_lpt(size_t *order, bool *slow, size_t jobs) {
+    uint64_t est[256];
+    uint64_t known_sum = 0, sum = 0;
+    size_t known = 0;
+
+    for (size_t i = 0; i < _star_test_count; i++) {
+        _star_history_entry *e = __star_history_find(_star_tests[i].name);
+        est[i] = e ? e->duration_ns : 0;
+        if (e) { known_sum += e->duration_ns; known++; }
+    }
+    for (size_t i = 0; i < _star_test_count; i++) {
+        if (!__star_history_find(_star_tests[i].name)) est[i] = known ? known_sum / known : 0;
+        sum += est[i];
+    }
+
+    for (size_t i = 0; i < _star_test_count; i++) {
+        size_t j = i;
+        while (j > 0 && est[order[j - 1]] < est[i]) { order[j] = order[j - 1]; j--; }
+        order[j] = i;
+    }
+
+    uint64_t bound = sum / jobs;
+    for (size_t i = 0; i < _star_test_count; i++) slow[i] = known && est[i] > 0 && est[i] >= bound;
+    return bound;
+}
+
+#if _STAR_POSIX
+typedef struct {
+    pid_t pid;
+    int   cmd;
+    int   res;
+    long  inflight;
+    bool  retire;
+} _star_job;
+
+static inline void __star_worker_loop(int cmd, int res) {
+    size_t index;
+    _star_result result;
+    while (read(cmd, &index, sizeof(index)) == (ssize_t)sizeof(index)) {
+        __star_run_one(index, &result);
+        fflush(stdout);
+        if (write(res, &result, sizeof(result)) != (ssize_t)sizeof(result)) break;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    __star_bench_flush();
+    _exit(0);
+}
+
+static inline bool __star_job_send(_star_job *job, size_t index) {
+    if (write(job->cmd, &index, sizeof(index)) != (ssize_t)sizeof(index)) return false;
+    job->inflight = (long)index;
+    return true;
+}
+
+static inline void __star_job_close(_star_job *job) {
+    if (job->cmd >= 0) close(job->cmd);
+    job->cmd = -1;
+}
+
+// Forks `jobs` workers and hands out tests in `order` to whichever worker is free, so the longest
+// tests start first. A worker that ran a known-slow test gets nothing else.
+static inline size_t __star_run_parallel(const size_t *order, const bool *slow, size_t count, size_t jobs) {
+    _star_job *pool = (_star_job *)calloc(jobs, sizeof(_star_job));
+    struct pollfd *fds = (struct pollfd *)calloc(jobs, sizeof(struct pollfd));
+    size_t started = 0, next = 0, done = 0;
+
+    if (!pool || !fds) {
+        free(pool);
+        free(fds);
+        return 0;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    __star_bench_flush();
+
+    for (; started < jobs && started < count; started++) {
+        int cmd[2], res[2];
+        if (pipe(cmd) != 0) break;
+        if (pipe(res) != 0) { close(cmd[0]); close(cmd[1]); break; }
+
+        pid_t pid = fork();
+        if (pid < 0) { close(cmd[0]); close(cmd[1]); close(res[0]); close(res[1]); break; }
+        if (pid == 0) {
+            for (size_t j = 0; j < started; j++) {
+                if (pool[j].cmd >= 0) close(pool[j].cmd);
+                close(pool[j].res);
+            }
+            close(cmd[1]);
+            close(res[0]);
+            __star_worker_loop(cmd[0], res[1]);
+        }
+        close(cmd[0]);
+        close(res[1]);
+        pool[started] = (_star_job){pid, cmd[1], res[0], -1, false};
+    }
+
+    for (size_t j = 0; j < started; j++) {
+        if (next < count && __star_job_send(&pool[j], order[next])) {
+            pool[j].retire = slow[order[next]];
+            next++;
+        } else {
+            __star_job_close(&pool[j]);
+        }
+    }
+
+    size_t open = started;
+    while (open > 0) {
+        size_t nfds = 0;
+        for (size_t j = 0; j < started; j++) {
+            if (pool[j].res < 0) continue;
+            fds[nfds].fd = pool[j].res;
+            fds[nfds].events = POLLIN;
+            fds[nfds].revents = 0;
+            nfds++;
+        }
+        if (poll(fds, nfds, -1) < 0) continue;
+
+        for (size_t j = 0, k = 0; j < started; j++) {
+            if (pool[j].res < 0) continue;
+            if (!fds[k++].revents) continue;
+
+            _star_result result;
+            ssize_t n = read(pool[j].res, &result, sizeof(result));
+            if (n == (ssize_t)sizeof(result)) {
+                _star_results[result.index] = result;
+                __star_report_result(&result);
+                done++;
+                pool[j].inflight = -1;
+
+                if (pool[j].retire || next >= count) {
+                    __star_job_close(&pool[j]);
+                } else if (__star_job_send(&pool[j], order[next])) {
+                    pool[j].retire = slow[order[next]];
+                    next++;
+                }
+                continue;
+            }
+
+            // Worker exited or died; whatever it was running counts as a crash.
+            if (pool[j].inflight >= 0) {
+                _star_result *crash = &_star_results[pool[j].inflight];
+                memset(crash, 0, sizeof(*crash));
+                crash->index   = (size_t)pool[j].inflight;
+                crash->failed  = true;
+                crash->crashed = true;
+                __star_report_result(crash);
+                done++;
+            }
+            __star_job_close(&pool[j]);
+            close(pool[j].res);
+            pool[j].res = -1;
+            waitpid(pool[j].pid, NULL, 0);
+            open--;
+        }
+
+        // Every remaining worker retired early (slow tests or crashes), run what is left in-process.
+        if (open == 0 && next < count) {
+            for (; next < count; next++) {
+                __star_run_one(order[next], &_star_results[order[next]]);
+                __star_report_result(&_star_results[order[next]]);
+                done++;
+            }
+        }
+    }
+
+    free(pool);
+    free(fds);
+    return done;
+}
+
+// Forked before the first test runs and kept idle, so that retries can be forked from a process
+// whose globals no test has touched yet. Without it they would inherit the state of the whole run.
+typedef struct {
+    pid_t pid;
+    int   cmd;
+    int   res;
+} _star_zygote_t;
+
+static _star_zygote_t _star_zygote = {-1, -1, -1};
+
+static inline size_t __star_run_forked(const size_t *seq, size_t n, _star_result *out, bool quiet);
+
+static inline void __star_zygote_loop(int cmd, int res) {
+    size_t n, quiet, seq[256];
+    _star_result out[256];
+    while (read(cmd, &n, sizeof(n)) == (ssize_t)sizeof(n) && n > 0 && n <= 256 &&
+           read(cmd, &quiet, sizeof(quiet)) == (ssize_t)sizeof(quiet)) {
+        size_t i = 0;
+        while (i < n && read(cmd, &seq[i], sizeof(seq[i])) == (ssize_t)sizeof(seq[i])) i++;
+        if (i < n) break;
+
+        size_t got = __star_run_forked(seq, n, out, quiet != 0);
+        if (write(res, &got, sizeof(got)) != (ssize_t)sizeof(got)) break;
+        for (i = 0; i < n && i <= got; i++) {
+            if (write(res, &out[i], sizeof(out[i])) != (ssize_t)sizeof(out[i])) break;
+        }
+    }
+    _exit(0);
+}
+
+static inline void __star_zygote_start() {
+    int cmd[2], res[2];
+    if (pipe(cmd) != 0) return;
+    if (pipe(res) != 0) { close(cmd[0]); close(cmd[1]); return; }
+
+    fflush(stdout);
+    fflush(stderr);
+    __star_bench_flush();
+
+    pid_t pid = fork();
+    if (pid < 0) { close(cmd[0]); close(cmd[1]); close(res[0]); close(res[1]); return; }
+    if (pid == 0) {
+        close(cmd[1]);
+        close(res[0]);
+        __star_zygote_loop(cmd[0], res[1]);
+    }
+    close(cmd[0]);
+    close(res[1]);
+    _star_zygote = (_star_zygote_t){pid, cmd[1], res[0]};
+}
+
+static inline void __star_zygote_stop() {
+    if (_star_zygote.pid <= 0) return;
+    close(_star_zygote.cmd);
+    close(_star_zygote.res);
+    waitpid(_star_zygote.pid, NULL, 0);
+    _star_zygote = (_star_zygote_t){-1, -1, -1};
+}
+
+// Asks the zygote to run `seq`. Returns false if it is not there (anymore).
+static inline bool __star_zygote_run(const size_t *seq, size_t n, _star_result *out, bool quiet, size_t *got) {
+    if (_star_zygote.pid <= 0) return false;
+    size_t flag = quiet;
+    bool ok = write(_star_zygote.cmd, &n, sizeof(n)) == (ssize_t)sizeof(n) &&
+              write(_star_zygote.cmd, &flag, sizeof(flag)) == (ssize_t)sizeof(flag);
+    for (size_t i = 0; ok && i < n; i++) ok = write(_star_zygote.cmd, &seq[i], sizeof(seq[i])) == (ssize_t)sizeof(seq[i]);
+    ok = ok && read(_star_zygote.res, got, sizeof(*got)) == (ssize_t)sizeof(*got);
+    for (size_t i = 0; ok && i < n && i <= *got; i++) ok = read(_star_zygote.res, &out[i], sizeof(out[i])) == (ssize_t)sizeof(out[i]);
+    if (!ok) {
+        __star_zygote_stop();
+        return false;
+    }
+    return true;
+}
+
+// Runs `seq` in order inside a fresh child process, forked from the zygote when there is one.
+// Returns how many results came back; the test after the last returned one (if any) crashed the child.
+static inline size_t __star_run_forked(const size_t *seq, size_t n, _star_result *out, bool quiet) {
+    fflush(stdout);
+    fflush(stderr);
+    __star_bench_flush();
+
+    size_t got = 0;
+    if (__star_zygote_run(seq, n, out, quiet, &got)) return got;
+
+    // Reported as a crash of the first test unless results come back.
+    if (n) {
+        memset(out, 0, sizeof(*out));
+        out->index   = seq[0];
+        out->failed  = true;
+        out->crashed = true;
+    }
+
+    int res[2];
+    if (pipe(res) != 0) return 0;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(res[0]);
+        close(res[1]);
+        return 0;
+    }
+    if (pid == 0) {
+        close(res[0]);
+        if (quiet) {
+            int null = open("/dev/null", O_WRONLY);
+            if (null >= 0) {
+                dup2(null, STDOUT_FILENO);
+                dup2(null, STDERR_FILENO);
+                close(null);
+            }
+        }
+        _star_result result;
+        for (size_t i = 0; i < n; i++) {
+            __star_run_one(seq[i], &result);
+            if (write(res[1], &result, sizeof(result)) != (ssize_t)sizeof(result)) break;
+        }
+        fflush(stdout);
+        fflush(stderr);
+        __star_bench_flush();
+        _exit(0);
+    }
+
+    close(res[1]);
+    while (got < n && read(res[0], &out[got], sizeof(out[got])) == (ssize_t)sizeof(out[got])) got++;
+    close(res[0]);
+    waitpid(pid, NULL, 0);
+
+    if (got < n) {
+        memset(&out[got], 0, sizeof(out[got]));
+        out[got].index   = seq[got];
+        out[got].failed  = true;
+        out[got].crashed = true;
+    }
+    return got;
+}
+#else
+// Without fork() every test runs in-process.
+static inline size_t __star_run_parallel(const size_t *order, const bool *slow, size_t count, size_t jobs) {
+    (void)order;
+    (void)slow;
+    (void)count;
+    (void)jobs;
+    return 0;
+}
+
+static inline void __star_zygote_start() {}
+static inline void __star_zygote_stop() {}
+
+// Without fork() there is no clean process to retry in, so a retry counts as failed.
+static inline size_t __star_run_forked(const size_t *seq, size_t n, _star_result *out, bool quiet) {
+    (void)quiet;
+    if (n) {
+        memset(out, 0, sizeof(*out));
+        out->index   = seq[0];
+        out->failed  = true;
+        out->crashed = true;
+    }
+    return 0;
+}
+#endif /* _STAR_POSIX */
+
+// Re-runs each failed test alone in a fresh process, up to `_star_retries` times.
+static inline void __star_retry_failed() {
+    for (size_t i = 0; i < _star_test_count; i++) {
+        _star_result *res = &_star_results[i];
+        if (!res->failed) continue;
+
+        for (unsigned attempt = 1; attempt <= _star_retries; attempt++) {
+            _star_result retry;
+            _STAR_RETRY("%s (attempt %u of %u)", _star_tests[i].name, attempt, _star_retries);
+            __star_run_forked(&i, 1, &retry, false);
+            if (!retry.failed) {
+                res->flaky   = true;
+                res->retries = attempt;
+                __star_report_result(res);
+                break;
+            }
+        }
+    }
+}
+
+/* RECORDS */
+#define STAR_RECORD_MAGIC   "STAR"
+#define STAR_RECORD_VERSION 2
+
+enum {
+    STAR_RECORD_FAILED      = 1 << 0,
+    STAR_RECORD_CRASHED     = 1 << 1,
+    STAR_RECORD_FLAKY       = 1 << 2,
+    STAR_RECORD_QUARANTINED = 1 << 3
+};
+
+typedef struct {
+    char    *name;
+    uint8_t  flags;
+    uint32_t asserts_total;
+    uint32_t asserts_failed;
+    uint64_t duration_ns;
+    uint64_t rss_growth;
+    uint64_t minflt;
+    uint64_t majflt;
+} _star_record_test;
+
+typedef struct {
+    char              *binary;
+    uint32_t           count;
+    _star_record_test *tests;
+} _star_record;
+
+static const char *_star_program = "star";
+static const char *_star_record_path = NULL;
+
+static inline uint8_t __star_result_flags(const _star_result *res) {
+    return (uint8_t)((res->failed      ? STAR_RECORD_FAILED      : 0)
+                   | (res->crashed     ? STAR_RECORD_CRASHED     : 0)
+                   | (res->flaky       ? STAR_RECORD_FLAKY       : 0)
+                   | (res->quarantined ? STAR_RECORD_QUARANTINED : 0));
+}
+
+static inline bool __star_write_str(FILE *f, const char *str) {
+    uint16_t len = (uint16_t)strlen(str);
+    return fwrite(&len, sizeof(len), 1, f) == 1 && fwrite(str, 1, len, f) == len;
+}
+
+static inline char *__star_read_str(FILE *f) {
+    uint16_t len;
+    if (fread(&len, sizeof(len), 1, f) != 1) return NULL;
+    char *str = (char *)malloc((size_t)len + 1);
+    if (!str) return NULL;
+    if (fread(str, 1, len, f) != len) {
+        free(str);
+        return NULL;
+    }
+    str[len] = '\0';
+    return str;
+}
+
+// Layout (native byte order): "STAR", u32 version, str binary, u32 count, then per test
+// u8 flags, u32 asserts total, u32 asserts failed, u64 duration ns, str name, and since version 2
+// u64 RSS growth bytes, u64 minor faults, u64 major faults. A str is u16 length + bytes.
+// Writes the record to an already open stream and closes it; `path` is only used for the error message.
+static inline bool __star_record_write_to(FILE *f, const char *path, const _star_result *results, size_t count) {
+    // The path as the binary was started, so same-named binaries in different directories stay apart.
+    uint32_t version = STAR_RECORD_VERSION, n = (uint32_t)count;
+    bool ok = fwrite(STAR_RECORD_MAGIC, 1, 4, f) == 4
+           && fwrite(&version, sizeof(version), 1, f) == 1
+           && __star_write_str(f, _star_program)
+           && fwrite(&n, sizeof(n), 1, f) == 1;
+
+    for (size_t i = 0; ok && i < count; i++) {
+        const _star_result *res = &results[i];
+        uint8_t flags = __star_result_flags(res);
+        uint32_t total = (uint32_t)res->asserts_total, failed = (uint32_t)res->asserts_failed;
+        ok = fwrite(&flags, sizeof(flags), 1, f) == 1
+          && fwrite(&total, sizeof(total), 1, f) == 1
+          && fwrite(&failed, sizeof(failed), 1, f) == 1
+          && fwrite(&res->duration_ns, sizeof(res->duration_ns), 1, f) == 1
+          && __star_write_str(f, _star_tests[res->index].name)
+          && fwrite(&res->rss_growth, sizeof(res->rss_growth), 1, f) == 1
+          && fwrite(&res->minflt, sizeof(res->minflt), 1, f) == 1
+          && fwrite(&res->majflt, sizeof(res->majflt), 1, f) == 1;
+    }
+
+    if (fclose(f) != 0) ok = false;
+    if (!ok) fprintf(stderr, "star: could not write record '%s'\n", path);
+    return ok;
+}
+
+static inline bool __star_record_write(const char *path, const _star_result *results, size_t count) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "star: could not write record '%s'\n", path);
+        return false;
+    }
+    return __star_record_write_to(f, path, results, count);
+}
+
+static inline void __star_record_free(_star_record *rec) {
+    for (uint32_t i = 0; rec->tests && i < rec->count; i++) free(rec->tests[i].name);
+    free(rec->tests);
+    free(rec->binary);
+    memset(rec, 0, sizeof(*rec));
+}
+
+static inline bool __star_record_read(const char *path, _star_record *rec) {
+    memset(rec, 0, sizeof(*rec));
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    char magic[4];
+    uint32_t version;
+    bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, STAR_RECORD_MAGIC, 4) == 0
+           && fread(&version, sizeof(version), 1, f) == 1 && version >= 1 && version <= STAR_RECORD_VERSION
+           && (rec->binary = __star_read_str(f)) != NULL
+           && fread(&rec->count, sizeof(rec->count), 1, f) == 1
+           && (rec->tests = (_star_record_test *)calloc(rec->count ? rec->count : 1, sizeof(_star_record_test))) != NULL;
+
+    for (uint32_t i = 0; ok && i < rec->count; i++) {
+        _star_record_test *t = &rec->tests[i];
+        ok = fread(&t->flags, sizeof(t->flags), 1, f) == 1
+          && fread(&t->asserts_total, sizeof(t->asserts_total), 1, f) == 1
+          && fread(&t->asserts_failed, sizeof(t->asserts_failed), 1, f) == 1
+          && fread(&t->duration_ns, sizeof(t->duration_ns), 1, f) == 1
+          && (t->name = __star_read_str(f)) != NULL;
+        if (ok && version >= 2) {
+            ok = fread(&t->rss_growth, sizeof(t->rss_growth), 1, f) == 1
+              && fread(&t->minflt, sizeof(t->minflt), 1, f) == 1
+              && fread(&t->majflt, sizeof(t->majflt), 1, f) == 1;
+        }
+    }
+
+    fclose(f);
+    if (!ok) __star_record_free(rec);
+    return ok;
+}
+
+static inline bool __star_record_counts_as_failure(uint8_t flags) {
+    return (flags & STAR_RECORD_FAILED) && !(flags & (STAR_RECORD_FLAKY | STAR_RECORD_QUARANTINED));
+}
+
+/* ORDERING */
+static bool _star_shuffle = false;
+static bool _star_seeded = false;
+static bool _star_bisect = false;
+static uint64_t _star_seed = 0;
+
+static inline uint64_t __star_splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static inline void __star_shuffle(size_t *order, size_t count, uint64_t seed) {
+    uint64_t state = seed;
+    for (size_t i = count; i > 1; i--) {
+        size_t j = (size_t)(__star_splitmix64(&state) % i);
+        size_t tmp = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = tmp;
+    }
+}
+
+// 1 if the last test of `seq` failed, 0 if it passed, -1 if an earlier test crashed before it ran.
+static inline int __star_probe(const size_t *seq, size_t n) {
+    _star_result out[257];
+    size_t got = __star_run_forked(seq, n, out, true);
+    if (got + 1 < n) return -1;
+    return out[n - 1].failed ? 1 : 0;
+}
+
+// Narrows `cand` down to one test that, run right before `victim`, flips its outcome away from
+// `alone`. Assumes a single culprit; returns the number of candidates left.
+static inline size_t __star_bisect_culprit(size_t *cand, size_t n, size_t victim, int alone) {
+    size_t seq[257];
+    while (n > 1) {
+        size_t half = n / 2;
+        memcpy(seq, cand, half * sizeof(size_t));
+        seq[half] = victim;
+        if (__star_probe(seq, half + 1) == !alone) {
+            n = half;
+            continue;
+        }
+        memcpy(seq, cand + half, (n - half) * sizeof(size_t));
+        seq[n - half] = victim;
+        if (__star_probe(seq, n - half + 1) != !alone) break;
+        memmove(cand, cand + half, (n - half) * sizeof(size_t));
+        n -= half;
+    }
+    return n;
+}
+
+// Runs `order` once, then for every test whose outcome depends on what ran before it, finds the
+// single test responsible. Every probe runs in its own process.
+static inline int __star_bisect_order(const size_t *order) {
+    size_t count = _star_test_count;
+    size_t registered[256], cand[256];
+    _star_result full[257];
+    int found = 0;
+
+    for (size_t i = 0; i < count; i++) registered[i] = i;
+
+    printf(STAR_FMT_BISECT "\n", count);
+    size_t got = __star_run_forked(order, count, full, true);
+
+    for (size_t p = 0; p < count; p++) {
+        if (p > got) break;  // never ran, an earlier test crashed the child
+        size_t victim = order[p];
+        bool in_order = full[p].failed;
+
+        int alone = __star_probe(&victim, 1);
+        if (alone < 0) continue;
+
+        // A failure in this order that passes alone has a polluter before it. A test that fails
+        // alone may have a provider before it in registration order.
+        size_t n = 0;
+        if (in_order && alone == 0) {
+            n = p;
+            memcpy(cand, order, n * sizeof(size_t));
+        } else if (alone == 1) {
+            for (n = 0; registered[n] != victim; n++) cand[n] = registered[n];
+            size_t seq[257];
+            memcpy(seq, cand, n * sizeof(size_t));
+            seq[n] = victim;
+            if (n == 0 || __star_probe(seq, n + 1) != 0) continue;
+        } else {
+            continue;
+        }
+        if (n == 0) continue;
+
+        n = __star_bisect_culprit(cand, n, victim, alone);
+        found++;
+        if (n == 1 && alone == 0) {
+            _STAR_TEST_FAIL("%s fails when run after %s (passes alone)",
+                            _star_tests[victim].name, _star_tests[cand[0]].name);
+        } else if (n == 1) {
+            _STAR_TEST_FAIL("%s only passes when run after %s (fails alone)",
+                            _star_tests[victim].name, _star_tests[cand[0]].name);
+        } else {
+            _STAR_TEST_FAIL("%s depends on the order of %zu earlier tests, no single culprit",
+                            _star_tests[victim].name, n);
+        }
+    }
+
+    _STAR_SUMMARY("%d order-dependent tests found", found);
+    return found ? 1 : 0;
+}
+
+static inline int __star_run_internal(bool verbose_start) {
     if (verbose_start) printf("\033[1mRunning %zu tests...\033[0m\n", _star_test_count);
 
     int passed_tests = 0;
     int failed_tests = 0;
+    size_t order[256];
+    bool slow[256];
+    uint64_t bound = 0;
+    size_t jobs = _star_jobs ? _star_jobs : 1;
 
-    for (int i = 0; i < (int)_star_test_count; i++) {
-        _star_current_failed = 0;
+    __star_history_load();
 
-        size_t before_total  = _star_asserts_total;
-        size_t before_failed = _star_asserts_failed;
-
-        _star_tests[i].func();
+    for (size_t i = 0; i < _star_test_count; i++) {
+        order[i] = i;
+        slow[i] = false;
+    }
+    if (_star_shuffle) {
+#if _STAR_POSIX
+        if (!_star_seeded) _star_seed = __star_now_ns() ^ ((uint64_t)getpid() << 32);
+#else
+        if (!_star_seeded) _star_seed = __star_now_ns();
+#endif
+        __star_shuffle(order, _star_test_count, _star_seed);
+        printf("Shuffled with seed %" PRIu64 " (replay with --seed=%" PRIu64 ")\n", _star_seed, _star_seed);
+    } else if (jobs > 1) {
+        bound = __star_schedule_lpt(order, slow, jobs);
+    }
 
-        size_t test_total  = _star_asserts_total  - before_total;
-        size_t test_failed = _star_asserts_failed - before_failed;
-        size_t test_passed = test_total - test_failed;
+    if (_star_bisect) return __star_bisect_order(order);
 
-        if (_star_current_failed) {
-            _STAR_TEST_FAIL("%s: %zu/%zu assertions passed (%zu failed)", _star_tests[i].name, test_passed, test_total, test_failed);
-            failed_tests++;
-        } else {
-            _STAR_TEST_PASS("%s: %zu/%zu assertions passed", _star_tests[i].name, test_passed, test_total);
-            passed_tests++;
+    if (_star_retries) __star_zygote_start();
+#ifdef STAR_PROFILE_ASSERTS
+    __star_prof_begin();
+#endif
+    uint64_t wall_start = __star_now_ns();
+    size_t ran = jobs > 1 ? __star_run_parallel(order, slow, _star_test_count, jobs) : 0;
+    if (!ran) {
+        bool async_done = false;
+        for (size_t i = 0; i < _star_test_count; i++) {
+            if (_star_tests[order[i]].async) {
+#if _STAR_LINUX
+                // The first async test starts all of them on one loop.
+                if (!async_done) __star_async_run_serial(order, i, _star_test_count);
+                async_done = true;
+                continue;
+#endif
+            }
+            __star_run_one(order[i], &_star_results[order[i]]);
+            __star_report_result(&_star_results[order[i]]);
         }
+        (void)async_done;
     }
+    if (_star_retries) {
+        __star_retry_failed();
+        __star_zygote_stop();
+    }
+    uint64_t wall_ns = __star_now_ns() - wall_start;
+
+    int flaky_tests = 0;
+    int quarantined_tests = 0;
+    size_t asserts_total = 0, asserts_failed = 0;
+    uint64_t cpu_ns = 0, peak_rss = 0, minflt = 0, majflt = 0;
+    size_t hungriest = 0;
+    for (size_t i = 0; i < _star_test_count; i++) {
+        _star_result *res = &_star_results[i];
+        if (res->failed && !res->flaky && _star_quarantine && __star_history_quarantined(_star_tests[i].name)) {
+            res->quarantined = true;
+            __star_report_result(res);
+        }
+
+        if (res->flaky) flaky_tests++;
+        else if (res->quarantined) quarantined_tests++;
+        else if (res->failed) failed_tests++;
+        else passed_tests++;
+        asserts_total  += res->asserts_total;
+        asserts_failed += res->asserts_failed;
+        cpu_ns         += res->duration_ns;
+        minflt         += res->minflt;
+        majflt         += res->majflt;
+        if (res->peak_rss > peak_rss) peak_rss = res->peak_rss;
+        if (res->rss_growth > _star_results[hungriest].rss_growth) hungriest = i;
+        __star_history_record(_star_tests[i].name, res->crashed ? 0 : res->duration_ns, res->failed, res->flaky);
+    }
+    __star_history_save();
 
-    size_t total_passed_asserts = _star_asserts_total - _star_asserts_failed;
+    size_t total_passed_asserts = asserts_total - asserts_failed;
 
     if (verbose_start) _STAR_SUMMARY("%d/%zu tests passed, %d failed " "(%zu/%zu assertions passed)", 
-        passed_tests, _star_test_count, failed_tests, total_passed_asserts, _star_asserts_total);
+        passed_tests, _star_test_count, failed_tests, total_passed_asserts, asserts_total);
+    if (verbose_start && _STAR_POSIX && _star_test_count) printf("Memory: peak RSS %" PRIu64 " KiB, largest growth +%" PRIu64 " KiB (%s), "
+        "%" PRIu64 " minor / %" PRIu64 " major page faults\n", peak_rss / 1024, _star_results[hungriest].rss_growth / 1024,
+        _star_tests[hungriest].name, minflt, majflt);
+    if (verbose_start && (flaky_tests || quarantined_tests)) printf("%d flaky (passed on retry), %d quarantined\n",
+        flaky_tests, quarantined_tests);
+    if (verbose_start && ran) printf("%zu jobs: %.3f ms wall, %.3f ms test time, %.3f ms lower bound\n",
+        jobs, wall_ns / 1e6, cpu_ns / 1e6, (bound ? bound : cpu_ns / jobs) / 1e6);
+#ifdef STAR_PROFILE_ASSERTS
+    // Forked workers keep their counts to themselves, only in-process runs can be profiled.
+    if (verbose_start && ran) printf("Assertion profile needs an in-process run, use -j 1\n");
+    else if (verbose_start) __star_prof_report(cpu_ns);
+#endif
+
+    if (_star_bench_csv)  fflush(_star_bench_csv);
+    if (_star_bench_json) fflush(_star_bench_json);
+    if (_star_record_path) __star_record_write(_star_record_path, _star_results, _star_test_count);
 
     return failed_tests ? 1 : 0;
 }
 
+/* Command Line */
+static inline const char *__star_arg_value(const char *arg, const char *prefix) {
+    size_t n = strlen(prefix);
+    return strncmp(arg, prefix, n) == 0 ? arg + n : NULL;
+}
+
+// A bare strtoull() reads "", "x" or "-1" as a number; options want all digits or an error.
+static inline bool __star_arg_number(const char *arg, const char *v, const char *what, unsigned long long *out) {
+    char *end = NULL;
+    errno = 0;
+    unsigned long long n = *v >= '0' && *v <= '9' ? strtoull(v, &end, 10) : 0;
+    if (!end || *end || errno == ERANGE) {
+        // Just the option: "-j" of "-jx", "--seed" of "--seed=x".
+        int len = arg[1] == '-' ? (int)strcspn(arg, "=") : 2;
+        fprintf(stderr, "star: %.*s expects %s, got '%s'\n", len, arg, what, v);
+        return false;
+    }
+    *out = n;
+    return true;
+}
+
+static inline FILE *__star_open_output(const char *path, const char *header) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "star: could not open '%s' for writing\n", path);
+        return NULL;
+    }
+    if (header) fputs(header, f);
+    return f;
+}
+
+static inline void __star_usage(const char *prog) {
+    printf("usage: %s [options]\n"
+           "  -j N, --jobs=N     run tests on N forked workers, longest first\n"
+           "  --history=PATH     per-test duration history (default with -j or retries: <binary>.star_history)\n"
+           "  --no-history       do not read or write the history file\n"
+           "  --retry-failed=N   re-run failed tests alone up to N times, passes count as flaky\n"
+           "  --shuffle          run tests in a random order, the seed is printed\n"
+           "  --seed=S           replay the shuffled order for seed S\n"
+           "  --bisect-order     find the pairs of tests that depend on each other's order\n"
+           "  --no-quarantine    fail on chronically flaky tests too\n"
+           "  --record=PATH      write a binary result record for star_merge\n"
+           "  --watch            rerun on changes to the binary, STAR_WATCH sources and TEST_INPUTS data\n"
+           "  --watch-build=CMD  command that rebuilds the binary when a watched source changes\n"
+           "  --bench-csv=PATH   write BENCH_RANGE results as CSV\n"
+           "  --bench-json=PATH  write BENCH_RANGE results as JSON lines\n",
+           prog);
+}
+
+static bool _star_help = false;
+
+// Returns false when the program should exit instead of running tests, with status 0 after `--help`.
+static inline bool __star_parse_args(int argc, char **argv) {
+    const char *v;
+    bool history = true;
+    if (argc > 0) _star_program = argv[0];
+    _star_argv = argv;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if ((v = __star_arg_value(arg, "--jobs=")) || (v = __star_arg_value(arg, "-j"))) {
+            if (!*v && i + 1 < argc) v = argv[++i];
+            unsigned long long jobs;
+            if (!__star_arg_number(arg, v, "a number of jobs", &jobs)) {
+                __star_usage(argv[0]);
+                return false;
+            }
+            _star_jobs = (size_t)jobs;
+            if (_star_jobs == 0) {
+#if _STAR_POSIX
+                long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+                _star_jobs = ncpu > 0 ? (size_t)ncpu : 1;
+#else
+                _star_jobs = 1;
+#endif
+            }
+        } else if ((v = __star_arg_value(arg, "--history="))) {
+            free(_star_history_path);
+            _star_history_path = __star_strdup(v);
+        } else if (strcmp(arg, "--no-history") == 0) {
+            history = false;
+        } else if ((v = __star_arg_value(arg, "--retry-failed="))) {
+            unsigned long long retries;
+            if (!__star_arg_number(arg, v, "a number of retries", &retries)) {
+                __star_usage(argv[0]);
+                return false;
+            }
+            _star_retries = (unsigned)retries;
+        } else if (strcmp(arg, "--no-quarantine") == 0) {
+            _star_quarantine = false;
+        } else if (strcmp(arg, "--shuffle") == 0) {
+            _star_shuffle = true;
+        } else if ((v = __star_arg_value(arg, "--seed="))) {
+            _star_shuffle = true;
+            _star_seeded = true;
+            unsigned long long seed;
+            if (!__star_arg_number(arg, v, "a numeric seed", &seed)) {
+                __star_usage(argv[0]);
+                return false;
+            }
+            _star_seed = (uint64_t)seed;
+        } else if (strcmp(arg, "--bisect-order") == 0) {
+            _star_bisect = true;
+        } else if (strcmp(arg, "--watch") == 0) {
+            _star_watch = true;
+        } else if ((v = __star_arg_value(arg, "--watch-build="))) {
+            _star_watch = true;
+            _star_watch_build = v;
+        } else if ((v = __star_arg_value(arg, "--record="))) {
+            _star_record_path = v;
+        } else if ((v = __star_arg_value(arg, "--bench-csv="))) {
+            _star_bench_csv = __star_open_output(v, "bench,size,threads,ops,wall_ns,ns_per_op,ops_per_sec\n");
+        } else if ((v = __star_arg_value(arg, "--bench-json="))) {
+            _star_bench_json = __star_open_output(v, NULL);
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            __star_usage(argv[0]);
+            _star_help = true;
+            return false;
+        } else {
+            fprintf(stderr, "star: unknown option '%s'\n", arg);
+            __star_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (!history) {
+        free(_star_history_path);
+        _star_history_path = NULL;
+    } else if (!_star_history_path && (_star_jobs > 1 || _star_retries) && argc > 0 && strchr(argv[0], '/')) {
+        // Only -j and --retry-failed read the history back. A bare argv[0] was found through PATH,
+        // which gives no directory of the binary to put the file in.
+        size_t len = strlen(argv[0]) + sizeof(".star_history");
+        _star_history_path = (char *)malloc(len);
+        if (_star_history_path) snprintf(_star_history_path, len, "%s.star_history", argv[0]);
+    }
+    return true;
+}
+
+/* Merging */
+#ifndef STAR_MERGE_TOP
+#define STAR_MERGE_TOP 10
+#endif
+
+typedef struct {
+    const char              *binary;
+    const _star_record_test *test;
+} _star_merge_entry;
+
+static inline int __star_merge_slower(const void *a, const void *b) {
+    uint64_t da = ((const _star_merge_entry *)a)->test->duration_ns;
+    uint64_t db = ((const _star_merge_entry *)b)->test->duration_ns;
+    return da < db ? 1 : da > db ? -1 : 0;
+}
+
+// Prints one summary over many records. `missing` counts binaries that never produced a record.
+static inline int __star_merge_report(_star_record *recs, size_t nrecs, size_t missing) {
+    size_t tests = 0, failed = 0, flaky = 0, quarantined = 0, asserts = 0, asserts_failed = 0;
+    uint64_t total_ns = 0, minflt = 0, majflt = 0;
+    _star_merge_entry hungriest = {NULL, NULL};
+
+    for (size_t r = 0; r < nrecs; r++) {
+        size_t bin_failed = 0;
+        uint64_t bin_ns = 0;
+        for (uint32_t i = 0; i < recs[r].count; i++) {
+            const _star_record_test *t = &recs[r].tests[i];
+            if (__star_record_counts_as_failure(t->flags)) bin_failed++;
+            if (t->flags & STAR_RECORD_FLAKY) flaky++;
+            if (t->flags & STAR_RECORD_QUARANTINED) quarantined++;
+            asserts        += t->asserts_total;
+            asserts_failed += t->asserts_failed;
+            bin_ns         += t->duration_ns;
+            minflt         += t->minflt;
+            majflt         += t->majflt;
+            if (!hungriest.test || t->rss_growth > hungriest.test->rss_growth) hungriest = (_star_merge_entry){recs[r].binary, t};
+        }
+        tests    += recs[r].count;
+        failed   += bin_failed;
+        total_ns += bin_ns;
+
+        if (bin_failed) _STAR_TEST_FAIL("%s: %zu/%u tests passed in %.3f ms", recs[r].binary,
+                                        recs[r].count - bin_failed, recs[r].count, bin_ns / 1e6);
+        else _STAR_TEST_PASS("%s: %u/%u tests passed in %.3f ms", recs[r].binary,
+                             recs[r].count, recs[r].count, bin_ns / 1e6);
+    }
+
+    _star_merge_entry *all = (_star_merge_entry *)calloc(tests ? tests : 1, sizeof(_star_merge_entry));
+    if (all) {
+        size_t n = 0;
+        for (size_t r = 0; r < nrecs; r++) {
+            for (uint32_t i = 0; i < recs[r].count; i++) all[n++] = (_star_merge_entry){recs[r].binary, &recs[r].tests[i]};
+        }
+        qsort(all, n, sizeof(*all), __star_merge_slower);
+
+        printf("\nSlowest tests:\n");
+        for (size_t i = 0; i < n && i < STAR_MERGE_TOP; i++) {
+            printf("  %10.3f ms  %s:%s\n", all[i].test->duration_ns / 1e6, all[i].binary, all[i].test->name);
+        }
+
+        if (failed) printf("\nFailures:\n");
+        for (size_t i = 0; i < n; i++) {
+            if (!__star_record_counts_as_failure(all[i].test->flags)) continue;
+            printf("  %s:%s%s\n", all[i].binary, all[i].test->name,
+                   (all[i].test->flags & STAR_RECORD_CRASHED) ? " (crashed)" : "");
+        }
+        free(all);
+    }
+
+    _STAR_SUMMARY("%zu/%zu tests passed across %zu binaries, %zu failed (%zu/%zu assertions passed)",
+                  tests - failed, tests, nrecs + missing, failed, asserts - asserts_failed, asserts);
+    if (flaky || quarantined) printf("%zu flaky (passed on retry), %zu quarantined\n", flaky, quarantined);
+    if (missing) printf("%zu binaries produced no record\n", missing);
+    if (hungriest.test) printf("Memory: largest growth +%" PRIu64 " KiB (%s:%s), %" PRIu64 " minor / %" PRIu64 " major page faults\n",
+                               hungriest.test->rss_growth / 1024, hungriest.binary, hungriest.test->name, minflt, majflt);
+    printf("%.3f ms total test time\n", total_ns / 1e6);
+
+    return (failed || missing) ? 1 : 0;
+}
+
+static inline void __star_merge_dump(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) fwrite(buf, 1, n, stdout);
+    fclose(f);
+}
+
+#if _STAR_POSIX
+// Launches every binary with `--record=`, at most `jobs` at a time. Output of each binary is kept
+// in a log and only shown if that binary did not pass.
+static inline int __star_merge_run(char **bins, size_t nbins, char **extra, size_t nextra, size_t jobs) {
+    char dir[] = "/tmp/star_merge.XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "star_merge: could not create a temporary directory\n");
+        return 2;
+    }
+
+    char (*recpaths)[64] = (char (*)[64])calloc(nbins, 64);
+    char (*logpaths)[64] = (char (*)[64])calloc(nbins, 64);
+    pid_t *pids = (pid_t *)calloc(nbins, sizeof(pid_t));
+    int   *status = (int *)calloc(nbins, sizeof(int));
+    char **args = (char **)calloc(nextra + 3, sizeof(char *));
+    _star_record *recs = (_star_record *)calloc(nbins, sizeof(_star_record));
+    if (!recpaths || !logpaths || !pids || !status || !args || !recs) {
+        free(recpaths); free(logpaths); free(pids); free(status); free(args); free(recs);
+        rmdir(dir);
+        return 2;
+    }
+
+    size_t next = 0, running = 0;
+    uint64_t start = __star_now_ns();
+    fflush(stdout);
+    fflush(stderr);
+
+    while (next < nbins || running > 0) {
+        while (next < nbins && running < jobs) {
+            snprintf(recpaths[next], 64, "%s/%zu.rec", dir, next);
+            snprintf(logpaths[next], 64, "%s/%zu.log", dir, next);
+
+            pid_t pid = fork();
+            if (pid < 0) status[next] = errno;
+            if (pid == 0) {
+                char record[80];
+                snprintf(record, sizeof(record), "--record=%s", recpaths[next]);
+                int log = open(logpaths[next], O_WRONLY | O_CREAT | O_TRUNC, 0600);
+                if (log >= 0) {
+                    dup2(log, STDOUT_FILENO);
+                    dup2(log, STDERR_FILENO);
+                    close(log);
+                }
+                args[0] = bins[next];
+                args[1] = record;
+                for (size_t i = 0; i < nextra; i++) args[2 + i] = extra[i];
+                args[2 + nextra] = NULL;
+                execv(bins[next], args);
+                fprintf(stderr, "star_merge: could not execute '%s'\n", bins[next]);
+                _exit(127);
+            }
+            pids[next] = pid;
+            if (pid > 0) running++;
+            next++;
+        }
+
+        int st;
+        pid_t done = waitpid(-1, &st, 0);
+        if (done < 0) break;
+        for (size_t i = 0; i < next; i++) {
+            if (pids[i] == done) status[i] = st;
+        }
+        running--;
+    }
+    uint64_t wall_ns = __star_now_ns() - start;
+
+    size_t nrecs = 0, missing = 0;
+    for (size_t i = 0; i < nbins; i++) {
+        bool passed = pids[i] > 0 && WIFEXITED(status[i]) && WEXITSTATUS(status[i]) == 0;
+        if (pids[i] < 0) {
+            printf(STAR_FMT_MERGE_BINARY "(not started, fork failed: %s)\n", bins[i], strerror(status[i]));
+        } else if (!passed) {
+            printf(STAR_FMT_MERGE_BINARY "(%s %d):\n", bins[i],
+                   WIFSIGNALED(status[i]) ? "signal" : "exit code",
+                   WIFSIGNALED(status[i]) ? WTERMSIG(status[i]) : WEXITSTATUS(status[i]));
+            __star_merge_dump(logpaths[i]);
+        }
+        if (__star_record_read(recpaths[i], &recs[nrecs])) {
+            // Reported under the path given on the command line, which tells same-named binaries apart.
+            char *path = __star_strdup(bins[i]);
+            if (path) {
+                free(recs[nrecs].binary);
+                recs[nrecs].binary = path;
+            }
+            nrecs++;
+        } else {
+            missing++;
+        }
+        unlink(recpaths[i]);
+        unlink(logpaths[i]);
+    }
+    rmdir(dir);
+
+    printf("\n");
+    int rc = __star_merge_report(recs, nrecs, missing);
+    printf("%zu binaries on %zu jobs in %.3f ms wall\n", nbins, jobs, wall_ns / 1e6);
+
+    for (size_t i = 0; i < nrecs; i++) __star_record_free(&recs[i]);
+    free(recpaths); free(logpaths); free(pids); free(status); free(args); free(recs);
+    return rc;
+}
+#endif /* _STAR_POSIX */
+
+// `star_merge RECORD...` merges existing records, `star_merge --run [-j N] BINARY... [-- ARGS...]`
+// runs the binaries concurrently first. Define STAR_MERGE_MAIN to make this the entrypoint.
+static inline int star_merge(int argc, char **argv) {
+    bool run = false;
+    size_t jobs = 0;
+    int first = 1;
+
+    for (; first < argc && argv[first][0] == '-'; first++) {
+        const char *v;
+        if (strcmp(argv[first], "--run") == 0) {
+            run = true;
+        } else if ((v = __star_arg_value(argv[first], "--jobs=")) || (v = __star_arg_value(argv[first], "-j"))) {
+            const char *opt = argv[first];
+            if (!*v && first + 1 < argc) v = argv[++first];
+            unsigned long long n;
+            if (!__star_arg_number(opt, v, "a number of jobs", &n)) return 2;
+            jobs = (size_t)n;
+        } else if (strcmp(argv[first], "--") == 0) {
+            break;
+        } else {
+            fprintf(stderr, "usage: %s RECORD...\n"
+                            "       %s --run [-j N] BINARY... [-- ARGS...]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    int last = first;
+    while (last < argc && strcmp(argv[last], "--") != 0) last++;
+    size_t ninputs = (size_t)(last - first);
+    if (ninputs == 0) {
+        fprintf(stderr, "%s: nothing to merge\n", argv[0]);
+        return 2;
+    }
+
+    if (run) {
+#if _STAR_POSIX
+        if (jobs == 0) {
+            long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+            jobs = ncpu > 0 ? (size_t)ncpu : 1;
+        }
+        int extra = last < argc ? last + 1 : argc;
+        return __star_merge_run(&argv[first], ninputs, &argv[extra], (size_t)(argc - extra), jobs);
+#else
+        (void)jobs;
+        fprintf(stderr, "%s: --run needs a POSIX platform\n", argv[0]);
+        return 2;
+#endif
+    }
+
+    _star_record *recs = (_star_record *)calloc(ninputs, sizeof(_star_record));
+    if (!recs) return 2;
+    size_t nrecs = 0, missing = 0;
+    for (size_t i = 0; i < ninputs; i++) {
+        if (__star_record_read(argv[first + i], &recs[nrecs])) nrecs++;
+        else {
+            fprintf(stderr, "%s: '%s' is not a STAR record\n", argv[0], argv[first + i]);
+            missing++;
+        }
+    }
+    int rc = __star_merge_report(recs, nrecs, missing);
+    for (size_t i = 0; i < nrecs; i++) __star_record_free(&recs[i]);
+    free(recs);
+    return rc;
+}
+
+/* Watching */
+#ifndef STAR_WATCH_DEBOUNCE_MS
+#define STAR_WATCH_DEBOUNCE_MS 150
+#endif
+
+static inline const char *__star_flags_label(uint8_t flags) {
+    if (flags & STAR_RECORD_FLAKY)       return "FLAKY";
+    if (flags & STAR_RECORD_QUARANTINED) return "QUARANTINED";
+    if (flags & STAR_RECORD_CRASHED)     return "CRASH";
+    if (flags & STAR_RECORD_FAILED)      return "FAIL";
+    return "PASS";
+}
+
+static inline bool __star_watch_diff_one(const char *name, int prev, uint8_t now, size_t *changes) {
+    if (prev >= 0 && __star_flags_label((uint8_t)prev) == __star_flags_label(now)) return false;
+    if (!*changes) printf(STAR_FMT_WATCH_DIFF "\n");
+    if (prev < 0) printf("  %s: new (%s)\n", name, __star_flags_label(now));
+    else printf("  %s: %s -> %s\n", name, __star_flags_label((uint8_t)prev), __star_flags_label(now));
+    (*changes)++;
+    return true;
+}
+
+static inline void __star_watch_diff_record(const _star_record *prev) {
+    size_t changes = 0;
+    for (size_t i = 0; i < _star_test_count; i++) {
+        int before = -1;
+        for (uint32_t j = 0; j < prev->count; j++) {
+            if (strcmp(prev->tests[j].name, _star_tests[i].name) == 0) before = prev->tests[j].flags;
+        }
+        __star_watch_diff_one(_star_tests[i].name, before, __star_result_flags(&_star_results[i]), &changes);
+    }
+    if (!changes) printf("\nNo changes since last run.\n");
+}
+
+#if _STAR_LINUX
+enum { STAR_WATCH_BINARY, STAR_WATCH_SOURCE, STAR_WATCH_DATA };
+
+typedef struct {
+    int    wd;
+    int    kind;
+    const char *base;
+    size_t decl;
+} _star_watch_entry;
+
+static inline bool __star_watch_add(int fd, _star_watch_entry *entries, size_t *count, const char *path, int kind, size_t decl) {
+    char dir[4096];
+    const char *slash = strrchr(path, '/');
+    if (slash) snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path) ? (int)(slash - path) : 1, path);
+    else snprintf(dir, sizeof(dir), ".");
+
+    // Watch the directory: editors and linkers usually replace files instead of writing them in place.
+    // IN_CREATE is left out on purpose, the file is not complete until it is closed or moved into place.
+    int wd = inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        fprintf(stderr, "star: cannot watch '%s'\n", path);
+        return false;
+    }
+    _star_watch_entry *e = &entries[(*count)++];
+    e->wd = wd;
+    e->kind = kind;
+    e->decl = decl;
+    e->base = slash ? slash + 1 : path;
+    return true;
+}
+
+static inline void __star_watch_reexec(const char *exe) {
+    // mkstemp() creates the file exclusively, so nothing can be planted at a guessed name beforehand.
+    char prev[] = "/tmp/star_watch.XXXXXX";
+    int tmp = mkstemp(prev);
+    FILE *f = tmp >= 0 ? fdopen(tmp, "wb") : NULL;
+    if (!f && tmp >= 0) close(tmp);
+    if (f && __star_record_write_to(f, prev, _star_results, _star_test_count)) setenv("STAR_WATCH_PREV", prev, 1);
+    else if (tmp >= 0) unlink(prev);
+
+    printf(STAR_FMT_WATCH_RESTART "\n");
+    fflush(stdout);
+    fflush(stderr);
+    execv(exe, _star_argv);
+    fprintf(stderr, "star: could not restart '%s'\n", exe);
+}
+
+// Re-runs, in this process, only the tests that declared one of the changed inputs.
+static inline void __star_watch_rerun(const bool *dirty) {
+    size_t changes = 0, ran = 0;
+    for (size_t i = 0; i < _star_test_count; i++) {
+        if (!dirty[i]) continue;
+        uint8_t before = __star_result_flags(&_star_results[i]);
+        if (!ran++) {
+            printf(STAR_FMT_WATCH_RERUN "\n");
+            fflush(stdout);
+        }
+        __star_run_one(i, &_star_results[i]);
+        __star_report_result(&_star_results[i]);
+        __star_watch_diff_one(_star_tests[i].name, before, __star_result_flags(&_star_results[i]), &changes);
+    }
+    if (ran && !changes) printf("\nNo changes since last run.\n");
+}
+
+static inline int __star_watch_loop() {
+    char exe[4096];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (len <= 0 || !_star_argv) {
+        fprintf(stderr, "star: --watch needs the program's command line\n");
+        return 2;
+    }
+    exe[len] = '\0';
+
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "star: inotify is not available\n");
+        return 2;
+    }
+
+    _star_watch_entry *entries = (_star_watch_entry *)calloc(_star_watch_count + 1, sizeof(_star_watch_entry));
+    if (!entries) {
+        close(fd);
+        return 2;
+    }
+    size_t nentries = 0;
+    __star_watch_add(fd, entries, &nentries, exe, STAR_WATCH_BINARY, 0);
+    for (size_t i = 0; i < _star_watch_count; i++) {
+        __star_watch_add(fd, entries, &nentries, _star_watches[i].path,
+                         _star_watches[i].test ? STAR_WATCH_DATA : STAR_WATCH_SOURCE, i);
+    }
+    printf(STAR_FMT_WATCH_WAIT "\n", nentries);
+
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool dirty[256];
+    for (;;) {
+        bool rebuilt = false, sources = false, data = false;
+        memset(dirty, 0, sizeof(dirty));
+        fflush(stdout);
+
+        // Block for the first event, then keep draining until things settle down.
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int timeout = -1;
+        while (poll(&pfd, 1, timeout) > 0) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) break;
+            for (char *p = buf; p < buf + n; ) {
+                const struct inotify_event *ev = (const struct inotify_event *)p;
+                p += sizeof(struct inotify_event) + ev->len;
+                if (!ev->len) continue;
+                for (size_t i = 0; i < nentries; i++) {
+                    if (entries[i].wd != ev->wd || strcmp(entries[i].base, ev->name) != 0) continue;
+                    if (entries[i].kind == STAR_WATCH_BINARY) {
+                        rebuilt = true;
+                    } else if (entries[i].kind == STAR_WATCH_SOURCE) {
+                        sources = true;
+                    } else {
+                        const char *test = _star_watches[entries[i].decl].test;
+                        for (size_t t = 0; t < _star_test_count; t++) {
+                            if (test && strcmp(_star_tests[t].name, test) == 0) dirty[t] = data = true;
+                        }
+                    }
+                }
+            }
+            timeout = STAR_WATCH_DEBOUNCE_MS;
+        }
+
+        if (sources && !rebuilt) {
+            if (_star_watch_build) {
+                printf(STAR_FMT_WATCH_BUILD "\n", _star_watch_build);
+                fflush(stdout);
+                if (system(_star_watch_build) != 0) printf("Build failed, waiting for the next change.\n");
+            } else {
+                printf("\nSources changed, waiting for the binary to be rebuilt.\n");
+            }
+            // A successful build rewrites the binary, which comes back around as `rebuilt`.
+            continue;
+        }
+        if (rebuilt) __star_watch_reexec(exe);
+        if (data) __star_watch_rerun(dirty);
+    }
+}
+#endif /* _STAR_LINUX */
+
+// Called once the first run is done: reports what changed since before the restart, then waits.
+static inline int __star_watch_main(int rc) {
+#if _STAR_LINUX
+    const char *prev = getenv("STAR_WATCH_PREV");
+    if (prev) {
+        _star_record rec;
+        if (__star_record_read(prev, &rec)) {
+            __star_watch_diff_record(&rec);
+            __star_record_free(&rec);
+        }
+        unlink(prev);
+        unsetenv("STAR_WATCH_PREV");
+    }
+    (void)rc;
+    return __star_watch_loop();
+#else
+    fprintf(stderr, "star: --watch is only supported on Linux\n");
+    return rc;
+#endif
+}
+
 /* Run Functionality */
-#if defined(STAR_NO_ENTRY)
+#if defined(STAR_MERGE_MAIN)
+int main(int argc, char** argv) {
+    return star_merge(argc, argv);
+}
+#elif defined(STAR_NO_ENTRY)
 static inline int star_run(int verbose_start) {
     return __star_run_internal(verbose_start);
 }
+
+// Same as star_run(), but honours the command line options listed by `--help`.
+static inline int star_run_args(int verbose_start, int argc, char **argv) {
+    if (!__star_parse_args(argc, argv)) return _star_help ? 0 : 2;
+    int rc = __star_run_internal(verbose_start);
+    return _star_watch ? __star_watch_main(rc) : rc;
+}
 #else
 int main(int argc, char** argv) {
-    return __star_run_internal(true);
+    if (!__star_parse_args(argc, argv)) return _star_help ? 0 : 2;
+    int rc = __star_run_internal(true);
+    return _star_watch ? __star_watch_main(rc) : rc;
 }
 #endif /* STAR_NO_ENTRY */
 
@@ -862,6 +3493,28 @@ int main(int argc, char** argv) {
 
 /*
     Revision history:
+        0.17.0 (2026-10-18)  STAR_PROFILE_ASSERTS records hits and cycles per assertion site and reports the hottest
+                             ones.
+        0.16.0 (2026-10-18)  TEST_ASYNC tests on a shared epoll loop with star_await_fd, star_await_cond, star_sleep_ms,
+                             star_after timers and star_spawn tasks (Linux).
+        0.15.0 (2026-10-18)  Equality, truthiness and comparison asserts on integer constant expressions are promoted
+                             to compile-time checks (`STAR_NO_STATIC_ASSERTS` keeps them at runtime).
+        0.14.0 (2026-10-18)  Per-test peak RSS growth and page faults in reports, records and summaries, plus
+                             TEST_MEMBUDGET to fail tests that grow past a memory budget.
+        0.13.0 (2026-10-18)  `--watch` mode: inotify-driven re-exec on rebuild, STAR_WATCH sources with an optional
+                             `--watch-build` command, TEST_INPUTS data reruns and pass/fail diffs between runs.
+        0.12.0 (2026-10-18)  `--record` writes binary result records, `star_merge` (STAR_MERGE_MAIN) merges them or
+                             runs many test binaries concurrently into one summary.
+        0.11.0 (2026-10-18)  `--shuffle`/`--seed` for reproducible random test order and `--bisect-order` to find
+                             the test pairs behind order-dependent failures.
+        0.10.0 (2026-10-18)  `--retry-failed=N` re-runs failed tests in isolation and reports them as flaky, flake
+                             statistics in the history file quarantine chronic offenders.
+        0.9.0  (2026-10-18)  Parallel runs on forked workers (`--jobs`) scheduled longest-first from a per-test
+                             duration history file. Test results now include their duration.
+        0.8.0  (2026-10-18)  Added BENCH_RANGE for size/thread sweeps with CSV and JSON output, plus command line
+                             parsing in the default entrypoint (`star_run_args` for STAR_NO_ENTRY).
+        0.7.0  (2026-10-18)  Added TEST_CONCURRENT for barrier-started, pinned multi-threaded tests with
+                             ops/sec reporting. Assertion counters are now atomic.
         0.6.2  (2025-11-27)  Fixed KINDANEQ/M logic to properly fail and append to global asserts + refactored
                              error message macros improved readability and consistency.
         0.6.1  (2025-11-25)  Added binary search collection asserts and custom messages.